@@ -0,0 +1,128 @@
+#include "Bench.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static std::atomic<uint64_t> g_allocCount(0);
+
+void *operator new(std::size_t size)
+{
+    ++g_allocCount;
+    if (auto p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    ++g_allocCount;
+    if (auto p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace ogui_bench
+{
+    struct Registration
+    {
+        const char *name;
+        BenchFn fn;
+    };
+
+    static std::vector<Registration> &getRegistrations()
+    {
+        static std::vector<Registration> registrations;
+        return registrations;
+    }
+
+    Registrar::Registrar(const char *name, BenchFn fn)
+    {
+        getRegistrations().push_back({ name, fn });
+    }
+
+    uint64_t getAllocCount()
+    {
+        return g_allocCount.load(std::memory_order_relaxed);
+    }
+
+    Result measure(const std::string &name, uint64_t opsPerCall, const std::function<void()> &fn, double minSeconds)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        fn(); // Warm up, so containers reach their steady state capacity
+
+        uint64_t calls = 0;
+        double elapsed = 0.0;
+        auto allocsBefore = getAllocCount();
+        auto start = Clock::now();
+        while (elapsed < minSeconds)
+        {
+            fn();
+            ++calls;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        auto allocs = getAllocCount() - allocsBefore;
+
+        Result result;
+        result.name = name;
+        result.ops = calls * opsPerCall;
+        result.nsPerOp = elapsed * 1e9 / (double)result.ops;
+        result.allocsPerOp = (double)allocs / (double)result.ops;
+        return result;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    using namespace ogui_bench;
+
+    bool json = false;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0) json = true;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else
+        {
+            printf("Usage: ogui_bench [--json] [--filter benchmark]\n");
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    bool isFailed = false;
+    for (const auto &registration : getRegistrations())
+    {
+        if (filter && !strstr(registration.name, filter)) continue;
+
+        std::vector<Result> benchResults;
+        registration.fn(benchResults);
+        for (const auto &result : benchResults)
+        {
+            results.push_back(result);
+            isFailed |= result.isFailed;
+            if (!json) printf("%-48s %14.1f ns/op %10.2f allocs/op%s\n", result.name.c_str(), result.nsPerOp, result.allocsPerOp, result.isFailed ? " FAILED" : "");
+        }
+    }
+
+    if (json)
+    {
+        printf("[\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &result = results[i];
+            printf("  { \"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f }%s\n",
+                   result.name.c_str(), (unsigned long long)result.ops, result.nsPerOp, result.allocsPerOp, i + 1 < results.size() ? "," : "");
+        }
+        printf("]\n");
+    }
+
+    return isFailed ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ogui_bench
+{
+    struct Result
+    {
+        std::string name;
+        uint64_t ops = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+        bool isFailed = false; // A check made by the bench didn't hold, ogui_bench then exits with 1
+    };
+
+    // Heap allocations made by the process so far. Counted by the global operator new of the bench executable.
+    uint64_t getAllocCount();
+
+    // Calls fn, which performs opsPerCall operations, until at least minSeconds elapsed
+    Result measure(const std::string &name, uint64_t opsPerCall, const std::function<void()> &fn, double minSeconds = 0.2);
+
+    // Benchmarks register themselves at static init time
+    using BenchFn = void (*)(std::vector<Result> &results);
+    struct Registrar
+    {
+        Registrar(const char *name, BenchFn fn);
+    };
+
+#define OGUI_BENCH(name) \
+    static void name(std::vector<ogui_bench::Result> &results); \
+    static ogui_bench::Registrar name##_registrar(#name, name); \
+    static void name(std::vector<ogui_bench::Result> &results)
+}
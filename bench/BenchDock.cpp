@@ -0,0 +1,146 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "Panel.h"
+#include "PanelsManager.h"
+
+#include <string>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+// Builds a balanced split tree of the given depth, alternating horizontal and vertical splits
+static void buildSplitTree(PanelsManager &panelsManager, uint32_t depth, std::vector<PanelRef> &panels)
+{
+    std::vector<uint32_t> leaves = { panelsManager.document_zone };
+    auto pFirstPanel = std::make_shared<Panel>();
+    panels.push_back(pFirstPanel);
+    DockContext dockContext;
+    dockContext.target = panelsManager.document_zone;
+    panelsManager.dockPanel(pFirstPanel, dockContext);
+
+    for (uint32_t level = 0; level < depth; ++level)
+    {
+        std::vector<uint32_t> nextLeaves;
+        for (auto leaf : leaves)
+        {
+            auto pPanel = std::make_shared<Panel>();
+            panels.push_back(pPanel);
+            dockContext.target = leaf;
+            dockContext.position = level % 2 ? eDockPanelPosition::Bottom : eDockPanelPosition::Right;
+            panelsManager.dockPanel(pPanel, dockContext);
+
+            int index;
+            nextLeaves.push_back(leaf);
+            nextLeaves.push_back(panelsManager.find(pPanel, &index));
+        }
+        leaves.swap(nextLeaves);
+    }
+}
+
+OGUI_BENCH(DockLayout)
+{
+    for (uint32_t depth : { 4u, 8u, 12u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+
+        std::vector<PanelRef> panels;
+        buildSplitTree(*ctx.pPanelsManager, depth, panels);
+
+        results.push_back(measure("updateLayout/depth" + std::to_string(depth), 1, [&]()
+        {
+            ctx.pPanelsManager->updateLayout(&ctx);
+            ctx.damageRects.clear();
+        }));
+    }
+}
+
+OGUI_BENCH(DockChurn)
+{
+    static const eDockPanelPosition POSITIONS[] = { eDockPanelPosition::Left, eDockPanelPosition::Bottom, eDockPanelPosition::Right, eDockPanelPosition::Top };
+
+    RecordingRenderer renderer;
+    Context ctx(&renderer, 1920, 1080);
+    auto pPanelsManager = ctx.pPanelsManager;
+
+    for (uint32_t panelCount : { 16u, 256u })
+    {
+        std::vector<PanelRef> panels;
+        for (uint32_t i = 0; i < panelCount; ++i)
+        {
+            auto pPanel = std::make_shared<Panel>();
+            pPanel->title = "Panel " + std::to_string(i);
+            panels.push_back(pPanel);
+        }
+
+        // Dock every panel next to the previous one, then take them all out again
+        results.push_back(measure("dock_undock_clean/" + std::to_string(panelCount), panelCount, [&]()
+        {
+            DockContext dockContext;
+            dockContext.target = pPanelsManager->document_zone;
+            for (uint32_t i = 0; i < panelCount; ++i)
+            {
+                dockContext.position = POSITIONS[i % 4];
+                pPanelsManager->dockPanel(panels[i], dockContext);
+                int index;
+                dockContext.target = pPanelsManager->find(panels[i], &index);
+            }
+            for (const auto &pPanel : panels)
+            {
+                pPanelsManager->undockPanel(pPanel);
+                pPanelsManager->cleanDock();
+            }
+        }));
+    }
+}
+
+OGUI_BENCH(DockIndex)
+{
+    static const uint32_t PANEL_COUNT = 10000;
+
+    RecordingRenderer renderer;
+    Context ctx(&renderer, 1920, 1080);
+    auto pPanelsManager = ctx.pPanelsManager;
+
+    // 64 zones, then the rest of the panels as tabs spread across them
+    std::vector<PanelRef> panels;
+    buildSplitTree(*pPanelsManager, 6, panels);
+    std::vector<uint32_t> zones;
+    for (const auto &pPanel : panels)
+    {
+        int index;
+        zones.push_back(pPanelsManager->find(pPanel, &index));
+    }
+    DockContext dockContext;
+    while (panels.size() < PANEL_COUNT)
+    {
+        auto pPanel = std::make_shared<Panel>();
+        dockContext.target = zones[panels.size() % zones.size()];
+        pPanelsManager->dockPanel(pPanel, dockContext);
+        panels.push_back(pPanel);
+    }
+
+    results.push_back(measure("find/" + std::to_string(PANEL_COUNT), PANEL_COUNT, [&]()
+    {
+        int index;
+        for (const auto &pPanel : panels) pPanelsManager->find(pPanel, &index);
+    }));
+
+    // Move the last tab of every zone to the next zone, as closing a document and reopening it elsewhere would
+    uint32_t round = 0;
+    results.push_back(measure("move_tab/" + std::to_string(PANEL_COUNT), zones.size(), [&]()
+    {
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            auto &zone = pPanelsManager->getZone(zones[i]);
+            auto pPanel = zone.panels.back();
+            pPanelsManager->undockPanel(pPanel);
+            pPanelsManager->cleanDock();
+            dockContext.target = zones[(i + 1 + round) % zones.size()];
+            pPanelsManager->dockPanel(pPanel, dockContext);
+        }
+        round = (round + 1) % (uint32_t)zones.size();
+    }));
+}
@@ -0,0 +1,102 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "ogui/IPanel.h"
+
+#include <string>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+static void resetDrawList(Context &ctx)
+{
+    ctx.frameTarget.clear();
+}
+
+static void benchRects(std::vector<Result> &results, bool indexedDraw, uint32_t rectCount)
+{
+    RendererCaps caps;
+    caps.indexedDraw = indexedDraw;
+    RecordingRenderer renderer(caps);
+    Context ctx(&renderer, 1920, 1080);
+
+    std::vector<Rect> rects(rectCount);
+    std::vector<Color> colors(rectCount);
+    std::vector<uint32_t> colors32(rectCount);
+    for (uint32_t i = 0; i < rectCount; ++i)
+    {
+        rects[i] = { (float)(i % 100) * 19.0f, (float)(i / 100 % 100) * 10.0f, 18.0f, 9.0f };
+        colors[i] = { (float)(i % 7) / 7.0f, (float)(i % 11) / 11.0f, (float)(i % 13) / 13.0f, 1.0f };
+        colors32[i] = 0x336699FF + i;
+    }
+
+    auto suffix = std::string(indexedDraw ? "/indexed/" : "/non-indexed/") + std::to_string(rectCount);
+
+    results.push_back(measure("drawRect_loop" + suffix, rectCount, [&]()
+    {
+        for (uint32_t i = 0; i < rectCount; ++i) ctx.drawRect(rects[i], colors[i]);
+        resetDrawList(ctx);
+    }));
+    results.push_back(measure("drawRects" + suffix, rectCount, [&]()
+    {
+        ctx.drawRects(rects.data(), colors.data(), rectCount);
+        resetDrawList(ctx);
+    }));
+    results.push_back(measure("drawRects_packed" + suffix, rectCount, [&]()
+    {
+        ctx.drawRects(rects.data(), colors32.data(), rectCount);
+        resetDrawList(ctx);
+    }));
+}
+
+OGUI_BENCH(Rects)
+{
+    benchRects(results, false, 10000);
+    benchRects(results, true, 10000);
+}
+
+// Docks panelCount panels around the documents view, alternating sides so the tree gets deep
+static void addPanels(IContext *pContext, uint32_t panelCount)
+{
+    static const eDockPosition POSITIONS[] = { eDockPosition::Left, eDockPosition::Bottom, eDockPosition::Right, eDockPosition::Top, eDockPosition::Center };
+
+    IPanelRef pPrevious;
+    for (uint32_t i = 0; i < panelCount; ++i)
+    {
+        auto pPanel = IPanel::create();
+        pPanel->setTitle("Panel " + std::to_string(i));
+        pContext->add(pPanel, pPrevious, POSITIONS[i % 5]);
+        pPrevious = pPanel;
+    }
+}
+
+static void benchRender(std::vector<Result> &results, uint32_t panelCount)
+{
+    RecordingRenderer renderer;
+    Context ctx(&renderer, 1920, 1080);
+    addPanels(&ctx, panelCount);
+    ctx.render();
+
+    auto suffix = "/" + std::to_string(panelCount);
+
+    // Nothing changed in the zones, cached geometry is replayed
+    results.push_back(measure("render_cached" + suffix, 1, [&]()
+    {
+        ctx.setDirty();
+        ctx.render();
+    }));
+
+    // Relayout bumps every zone's version, all geometry is regenerated
+    results.push_back(measure("render_rebuild" + suffix, 1, [&]()
+    {
+        ctx.updateLayout();
+        ctx.render();
+    }));
+}
+
+OGUI_BENCH(Render)
+{
+    benchRender(results, 16);
+    benchRender(results, 256);
+}
@@ -0,0 +1,141 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "Panel.h"
+#include "PanelsManager.h"
+#include "ogui/Widget.h"
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+class BenchRow final : public Widget
+{
+public:
+    Vec2 measure(Context *pContext, const Vec2 &available) override
+    {
+        return { available.x, pContext->theme.controlHeight };
+    }
+};
+
+OGUI_BENCH(HitTest)
+{
+    static const uint32_t POINT_COUNT = 4096;
+
+    // 256 panels, each splitting the one before it in two, scrolled somewhere in the middle of their rows
+    for (uint32_t rowsPerPanel : { 20u, 200u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+
+        std::vector<PanelRef> panels;
+        ctx.beginUpdate();
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            auto pPanel = std::make_shared<Panel>();
+            ctx.add(pPanel, panels.empty() ? nullptr : panels[i / 2], i % 2 ? eDockPosition::Bottom : eDockPosition::Right);
+            panels.push_back(pPanel);
+        }
+        ctx.endUpdate();
+
+        std::mt19937 rng(1);
+        for (const auto &pPanel : panels)
+        {
+            pPanel->beginUpdate();
+            for (uint32_t i = 0; i < rowsPerPanel; ++i) pPanel->add(std::make_shared<BenchRow>());
+            pPanel->endUpdate();
+            pPanel->layoutWidgets();
+            pPanel->setScrollOffset((float)(rng() % 1000));
+            pPanel->layoutWidgets();
+        }
+
+        std::vector<Vec2> points(POINT_COUNT);
+        for (auto &point : points) point = { (float)(rng() % 1920), (float)(rng() % 1080) };
+
+        auto total = std::to_string(256 * rowsPerPanel);
+        uint32_t hits = 0;
+        results.push_back(measure("dock/widgets" + total, POINT_COUNT, [&]()
+        {
+            for (const auto &point : points) hits += ctx.pPanelsManager->hitTest(point.x, point.y) != nullptr;
+        }));
+        results.push_back(measure("widget/widgets" + total, POINT_COUNT, [&]()
+        {
+            for (const auto &point : points)
+            {
+                if (auto pPanel = ctx.pPanelsManager->activePanelAt(point.x, point.y)) hits += pPanel->hitTest(point.x, point.y) != nullptr;
+            }
+        }));
+        if (!hits) results.back().name += " (no hits)";
+    }
+}
+
+OGUI_BENCH(InputFlood)
+{
+    // A split between two panels of rows is dragged, with this many mouse moves coming in per frame
+    for (uint32_t movesPerFrame : { 1u, 16u, 1000u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+
+        auto pLeft = std::make_shared<Panel>();
+        auto pRight = std::make_shared<Panel>();
+        ctx.add(pLeft, nullptr, eDockPosition::Center);
+        ctx.add(pRight, pLeft, eDockPosition::Right);
+        for (const auto &pPanel : { pLeft, pRight })
+        {
+            pPanel->beginUpdate();
+            for (uint32_t i = 0; i < 2000; ++i) pPanel->add(std::make_shared<BenchRow>());
+            pPanel->endUpdate();
+        }
+        ctx.render();
+
+        auto handleX = (int)(pRight->clientRect.x - ctx.theme.panelMargin * 0.5f);
+        ctx.onMouseMove(handleX, 500);
+        ctx.onMouseButtonDown(0);
+        ctx.render();
+
+        uint32_t frame = 0;
+        results.push_back(measure("drag_split/moves" + std::to_string(movesPerFrame), movesPerFrame, [&]()
+        {
+            for (uint32_t i = 0; i < movesPerFrame; ++i) ctx.onMouseMove(700 + (int)((++frame * 7) % 500), 500);
+            ctx.render();
+        }));
+    }
+}
+
+OGUI_BENCH(PostInvalidate)
+{
+    // A background job reports progress on one row this many times per frame. Posts of the same row coalesce, the row
+    // is measured once per frame and the loop woken once.
+    for (uint32_t postsPerFrame : { 1u, 1000u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+        auto pPanel = std::make_shared<Panel>();
+        ctx.add(pPanel, nullptr, eDockPosition::Center);
+        auto pRow = std::make_shared<BenchRow>();
+        pPanel->add(pRow);
+        ctx.render();
+
+        std::atomic<uint32_t> wakes{ 0 };
+        ctx.setWakeCallback([&wakes]() { wakes.fetch_add(1, std::memory_order_relaxed); });
+
+        uint64_t frames = 0;
+        results.push_back(measure("same_widget/posts" + std::to_string(postsPerFrame), postsPerFrame, [&]()
+        {
+            std::thread worker([&]()
+            {
+                for (uint32_t i = 0; i < postsPerFrame; ++i) ctx.postInvalidate(pRow);
+            });
+            worker.join();
+            ctx.render();
+            ++frames;
+        }));
+        results.back().name += " (" + std::to_string(wakes.load()) + " wakes/" + std::to_string(frames) + " frames)";
+    }
+}
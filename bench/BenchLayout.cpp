@@ -0,0 +1,83 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "Font.h"
+#include "PanelsManager.h"
+#include "ogui/IPanel.h"
+#include "ogui/Widget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+// Label and value, like a row of a property panel. Measuring wraps the label to the width, which costs a text measure.
+class BenchPropertyRow final : public Widget
+{
+public:
+    std::string label;
+
+    Vec2 measure(Context *pContext, const Vec2 &available) override
+    {
+        auto width = available.x;
+        const auto &theme = pContext->theme;
+        auto pFont = pContext->getFont(theme.font, theme.fontSize);
+        auto labelWidth = pFont->measure(label);
+        auto lines = std::max(1.0f, std::ceil(labelWidth / std::max(1.0f, width - theme.numericControlWidth - theme.controlMargin)));
+        return { available.x, lines * theme.controlHeight };
+    }
+};
+
+OGUI_BENCH(Layout)
+{
+    static const uint32_t ROW_COUNT = 5000;
+
+    RecordingRenderer renderer;
+    Context ctx(&renderer, 1920, 1080);
+
+    // Properties panel below the documents view, the split between them is dragged up and down
+    auto pDocuments = IPanel::create();
+    auto pProperties = IPanel::create();
+    ctx.add(pDocuments, nullptr, eDockPosition::Center);
+    ctx.add(pProperties, pDocuments, eDockPosition::Bottom);
+    std::vector<std::shared_ptr<BenchPropertyRow>> rows;
+    pProperties->beginUpdate();
+    for (uint32_t i = 0; i < ROW_COUNT; ++i)
+    {
+        auto pRow = std::make_shared<BenchPropertyRow>();
+        pRow->label = "Property number " + std::to_string(i);
+        pProperties->add(pRow);
+        rows.push_back(pRow);
+    }
+    pProperties->endUpdate();
+    ctx.render();
+
+    auto split = ctx.pPanelsManager->nodes[ctx.pPanelsManager->dock_root].type == eDockNodeType::VSplit ? ctx.pPanelsManager->dock_root : DOCK_NULL;
+    auto suffix = "/" + std::to_string(ROW_COUNT);
+
+    // Panel height changes, widths don't
+    uint32_t frame = 0;
+    results.push_back(measure("drag_vsplit" + suffix, 1, [&]()
+    {
+        ctx.pPanelsManager->nodes[split].amount = 0.4f + 0.1f * (float)(++frame % 3);
+        ctx.updateLayout();
+        ctx.render();
+    }));
+
+    // Panel width changes, every row is measured again
+    results.push_back(measure("resize_width" + suffix, 1, [&]()
+    {
+        ctx.onResize(1600 + (int)(++frame % 3) * 100, 1080);
+        ctx.render();
+    }));
+
+    // One row changed
+    results.push_back(measure("invalidate_one" + suffix, 1, [&]()
+    {
+        rows[++frame % ROW_COUNT]->invalidate();
+        ctx.render();
+    }));
+}
@@ -0,0 +1,195 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "ogui/IListView.h"
+#include "ogui/IPanel.h"
+#include "ogui/ITreeView.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+class BenchListDataSource final : public IListDataSource
+{
+public:
+    uint32_t count = 0;
+
+    uint32_t getCount() const override { return count; }
+    void getText(uint32_t index, std::string &text) const override { text = "Item "; text += std::to_string(index); }
+};
+
+// Every item has childCount children, down to depth levels
+class BenchTreeDataSource final : public ITreeDataSource
+{
+public:
+    uint32_t childCount = 0;
+    uint32_t depth = 0;
+
+    // Items encode their depth in the high bits and their path in the low bits
+    uint32_t getChildCount(uint64_t item) const override { return item == TREE_ROOT ? childCount : ((item >> 56) + 1 < depth ? childCount : 0); }
+    uint64_t getChild(uint64_t item, uint32_t index) const override
+    {
+        if (item == TREE_ROOT) return index;
+        auto childDepth = (item >> 56) + 1;
+        return (childDepth << 56) | ((item & 0x00FFFFFFFFFFFFFFull) * childCount + index);
+    }
+    void getText(uint64_t item, std::string &text) const override { text = "Node "; text += std::to_string(item & 0x00FFFFFFFFFFFFFFull); }
+};
+
+// Scrolls the panel by a few rows and renders, wrapping at the end of the content
+static Result benchScroll(const std::string &name, Context &ctx, const IPanelRef &pPanel, float contentHeight)
+{
+    ctx.render();
+    float scrollOffset = 0.0f;
+    return measure(name, 1, [&]()
+    {
+        scrollOffset += ctx.theme.listItemHeight * 3.0f;
+        if (scrollOffset > contentHeight) scrollOffset = 0.0f;
+        pPanel->setScrollOffset(scrollOffset);
+        ctx.render();
+    });
+}
+
+OGUI_BENCH(VirtualList)
+{
+    for (uint32_t count : { 1000u, 1000000u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+        auto pPanel = IPanel::create();
+        ctx.add(pPanel, nullptr, eDockPosition::Center);
+
+        BenchListDataSource dataSource;
+        dataSource.count = count;
+        pPanel->add(IListView::create(&dataSource));
+
+        results.push_back(benchScroll("list_scroll/" + std::to_string(count), ctx, pPanel, (float)count * ctx.theme.listItemHeight));
+    }
+
+    // 1000 or 1M rows, with every top level item expanded
+    for (uint32_t childCount : { 31u, 1000u })
+    {
+        RecordingRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+        auto pPanel = IPanel::create();
+        ctx.add(pPanel, nullptr, eDockPosition::Center);
+
+        BenchTreeDataSource dataSource;
+        dataSource.childCount = childCount;
+        dataSource.depth = 3;
+        auto pTree = ITreeView::create(&dataSource);
+        for (uint32_t i = childCount; i-- > 0;) pTree->setExpanded(i, true);
+        pPanel->add(pTree);
+
+        auto rowCount = pTree->getRowCount();
+        results.push_back(benchScroll("tree_scroll/" + std::to_string(rowCount), ctx, pPanel, (float)rowCount * ctx.theme.listItemHeight));
+    }
+}
+
+OGUI_BENCH(ParallelZones)
+{
+    static const uint32_t CHECKED_FRAMES = 16;
+
+    // Frames one thread draws for the checked scroll sequence. Every thread count must draw the same ones.
+    std::vector<RecordingRenderer> expectedFrames;
+
+    // 8 lists side by side and stacked, all scrolled every frame
+    for (uint32_t threadCount : { 1u, 2u, 4u, 8u })
+    {
+        RecordingRenderer renderer;
+        renderer.isDrawingText = true;
+        Context ctx(&renderer, 3840, 2160);
+        ctx.setRenderThreads(threadCount);
+
+        BenchListDataSource dataSource;
+        dataSource.count = 100000;
+        std::vector<IPanelRef> panels;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            auto pPanel = IPanel::create();
+            ctx.add(pPanel, panels.empty() ? nullptr : panels[i / 2], i % 2 ? eDockPosition::Bottom : eDockPosition::Right);
+            pPanel->add(IListView::create(&dataSource));
+            panels.push_back(pPanel);
+        }
+
+        ctx.render();
+        float scrollOffset = 0.0f;
+        auto contentHeight = (float)dataSource.count * ctx.theme.listItemHeight;
+        results.push_back(measure("lists8/threads" + std::to_string(threadCount), 1, [&]()
+        {
+            scrollOffset += ctx.theme.listItemHeight * 3.0f;
+            if (scrollOffset > contentHeight) scrollOffset = 0.0f;
+            for (const auto &pPanel : panels) pPanel->setScrollOffset(scrollOffset);
+            ctx.render();
+        }));
+
+        // Each panel scrolled differently, by rows and by part of a row
+        renderer.isRecording = true;
+        uint32_t mismatches = 0;
+        for (uint32_t frame = 0; frame < CHECKED_FRAMES; ++frame)
+        {
+            for (uint32_t i = 0; i < (uint32_t)panels.size(); ++i)
+            {
+                panels[i]->setScrollOffset((float)(frame * (i + 1)) * ctx.theme.listItemHeight * 2.5f);
+            }
+            ctx.render();
+
+            if (threadCount == 1) expectedFrames.push_back(renderer);
+            else if (!renderer.isSameFrame(expectedFrames[frame])) ++mismatches;
+        }
+        if (threadCount != 1)
+        {
+            results.back().name += " (" + std::to_string(CHECKED_FRAMES - mismatches) + "/" + std::to_string(CHECKED_FRAMES) + " frames as threads1)";
+            results.back().isFailed = mismatches != 0;
+        }
+    }
+}
+
+// Blocks in endFrame(), like a renderer waiting for vsync
+class StalledRenderer final : public IRenderer
+{
+public:
+    uintptr_t createTexture(uint32_t /*width*/, uint32_t /*height*/, uint8_t * /*pData*/) override { return ++nextTextureId; }
+    uintptr_t updateTexture(uintptr_t textureId, uint32_t /*width*/, uint32_t /*height*/, uint8_t * /*pData*/) override { return textureId; }
+    void destroyTexture(uintptr_t /*textureId*/) override {}
+    void beginFrame() override {}
+    void setVertexData(const Vertex * /*pData*/, uint32_t /*count*/) override {}
+    void scissor(uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/) override {}
+    void bindTexture(uintptr_t /*textureId*/) override {}
+    void draw(uint32_t /*startOffset*/, uint32_t /*count*/) override {}
+    void userDraw(UserDrawFn /*userDrawFn*/, void * /*pUserData*/, const uint32_t * /*viewport*/) override {}
+    void endFrame() override { std::this_thread::sleep_for(std::chrono::milliseconds(4)); }
+
+private:
+    uintptr_t nextTextureId = 0;
+};
+
+OGUI_BENCH(SubmitThread)
+{
+    // How long render() holds the UI thread, scrolling a list every frame, when the renderer takes 4ms per frame
+    for (bool isThreaded : { false, true })
+    {
+        StalledRenderer renderer;
+        Context ctx(&renderer, 1920, 1080);
+        ctx.setSubmitThread(isThreaded);
+        auto pPanel = IPanel::create();
+        ctx.add(pPanel, nullptr, eDockPosition::Center);
+
+        BenchListDataSource dataSource;
+        dataSource.count = 100000;
+        pPanel->add(IListView::create(&dataSource));
+
+        results.push_back(benchScroll(std::string("stalled_renderer/") + (isThreaded ? "thread" : "inline"), ctx, pPanel, (float)dataSource.count * ctx.theme.listItemHeight));
+
+        // Frames the renderer never saw, out of the most recent ones
+        std::vector<FrameStats> history(FRAME_STATS_HISTORY_SIZE);
+        auto count = ctx.getFrameStatsHistory(history.data(), (uint32_t)history.size());
+        uint32_t dropped = 0;
+        for (uint32_t i = 0; i < count; ++i) dropped += history[i].droppedFrameCount;
+        results.back().name += " (dropped " + std::to_string(dropped) + "/" + std::to_string(count) + ")";
+    }
+}
@@ -0,0 +1,88 @@
+#include "Bench.h"
+#include "RecordingRenderer.h"
+#include "Context.h"
+#include "Panel.h"
+#include "ogui/Widget.h"
+
+#include <string>
+#include <vector>
+
+using namespace ogui;
+using namespace ogui_bench;
+
+OGUI_BENCH(PanelWidgets)
+{
+    for (uint32_t widgetCount : { 1000u, 10000u })
+    {
+        std::vector<WidgetRef> widgets;
+        for (uint32_t i = 0; i < widgetCount; ++i) widgets.push_back(std::make_shared<Widget>());
+
+        auto suffix = "/" + std::to_string(widgetCount);
+
+        results.push_back(measure("Panel::add" + suffix, widgetCount, [&]()
+        {
+            Panel panel;
+            for (const auto &pWidget : widgets) panel.add(pWidget);
+        }));
+
+        // Insert before the last added widget, which sits at the back of the panel
+        results.push_back(measure("Panel::insertBefore" + suffix, widgetCount, [&]()
+        {
+            Panel panel;
+            panel.add(widgets[0]);
+            for (uint32_t i = 1; i < widgetCount; ++i) panel.insertBefore(widgets[i], widgets[i - 1]);
+        }));
+
+        // Add then remove from the front, as a property panel drops its rows in order when the selection changes
+        Panel panel;
+        results.push_back(measure("Panel::remove" + suffix, widgetCount, [&]()
+        {
+            for (const auto &pWidget : widgets) panel.add(pWidget);
+            for (const auto &pWidget : widgets) panel.remove(pWidget);
+        }));
+    }
+}
+
+OGUI_BENCH(UpdateBatch)
+{
+    static const uint32_t WIDGET_COUNT = 5000;
+    static const uint32_t PANEL_COUNT = 60;
+    static const eDockPosition POSITIONS[] = { eDockPosition::Right, eDockPosition::Bottom, eDockPosition::Center, eDockPosition::Left, eDockPosition::Top };
+
+    RecordingRenderer renderer;
+    Context ctx(&renderer, 1920, 1080);
+
+    std::vector<WidgetRef> widgets;
+    for (uint32_t i = 0; i < WIDGET_COUNT; ++i) widgets.push_back(std::make_shared<Widget>());
+
+    auto pPanel = IPanel::create();
+    ctx.add(pPanel, nullptr, eDockPosition::Center);
+
+    // Fill a docked panel, then clear it
+    for (bool isBatched : { false, true })
+    {
+        results.push_back(measure(std::string(isBatched ? "Panel::add_batched/" : "Panel::add/") + std::to_string(WIDGET_COUNT), WIDGET_COUNT, [&]()
+        {
+            if (isBatched) pPanel->beginUpdate();
+            for (const auto &pWidget : widgets) pPanel->add(pWidget);
+            if (isBatched) pPanel->endUpdate();
+            pPanel->clear();
+            ctx.damageRects.clear();
+        }));
+    }
+
+    // Restore a layout, then close it
+    std::vector<IPanelRef> panels;
+    for (uint32_t i = 0; i < PANEL_COUNT; ++i) panels.push_back(IPanel::create());
+    for (bool isBatched : { false, true })
+    {
+        results.push_back(measure(std::string(isBatched ? "Context::add_batched/" : "Context::add/") + std::to_string(PANEL_COUNT), PANEL_COUNT, [&]()
+        {
+            if (isBatched) ctx.beginUpdate();
+            for (uint32_t i = 0; i < PANEL_COUNT; ++i) ctx.add(panels[i], i ? panels[i - 1] : pPanel, POSITIONS[i % 5]);
+            for (const auto &pPanelToRemove : panels) ctx.remove(pPanelToRemove);
+            if (isBatched) ctx.endUpdate();
+            ctx.damageRects.clear();
+        }));
+    }
+}
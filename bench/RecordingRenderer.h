@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ogui/IRenderer.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ogui_bench
+{
+    // Renderer that does nothing but count what it receives. With isRecording, it also keeps what the last frame
+    // submitted, so frames of two contexts can be compared.
+    class RecordingRenderer final : public ogui::IRenderer
+    {
+    public:
+        RecordingRenderer(const ogui::RendererCaps &in_caps = ogui::RendererCaps()) : caps(in_caps) {}
+
+        ogui::RendererCaps getCaps() const override { return caps; }
+
+        // With isDrawingText, glyphs are boxes, so text is measured per character and drawn
+        bool rasterizeGlyph(const std::string & /*font*/, float fontSize, uint32_t codepoint, ogui::GlyphMetrics &metrics, std::vector<uint8_t> &pixels) override
+        {
+            if (!isDrawingText) return false;
+            metrics.advance = (float)(int)(fontSize * 0.4f) + (float)(codepoint % 3);
+            metrics.offsetX = 0;
+            metrics.offsetY = 2;
+            metrics.width = codepoint == ' ' ? 0 : (uint32_t)(fontSize * 0.4f);
+            metrics.height = (uint32_t)fontSize - 4;
+            pixels.assign(metrics.width * metrics.height * 4, 0xff);
+            return true;
+        }
+
+        uintptr_t createTexture(uint32_t /*width*/, uint32_t /*height*/, uint8_t * /*pData*/) override { ++textureCreates; return ++nextTextureId; }
+        uintptr_t updateTexture(uintptr_t textureId, uint32_t /*width*/, uint32_t /*height*/, uint8_t * /*pData*/) override { ++textureUpdates; return textureId; }
+        void updateTextureRegion(uintptr_t /*textureId*/, uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/, uint32_t /*stride*/, const uint8_t * /*pData*/) override { ++textureUpdates; }
+        void destroyTexture(uintptr_t /*textureId*/) override {}
+        void beginFrame() override { ++frames; clearFrame(); }
+        void beginFrame(const ogui::Rect * /*pDamageRects*/, uint32_t /*count*/) override { ++frames; clearFrame(); }
+        void setVertexData(const ogui::Vertex *pData, uint32_t count) override { vertices += count; recordVertices(pData, sizeof(ogui::Vertex) * count); }
+        void setVertexData(const ogui::CompactVertex *pData, uint32_t count) override { vertices += count; recordVertices(pData, sizeof(ogui::CompactVertex) * count); }
+        void setIndexData(const uint32_t * /*pData*/, uint32_t count) override { record(eCommand::SetIndexData, count); }
+        void scissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override { record(eCommand::Scissor, x, y, width, height); }
+        void bindTexture(uintptr_t textureId) override { ++textureBinds; record(eCommand::BindTexture, (uint32_t)textureId); }
+        void draw(uint32_t startOffset, uint32_t count) override { ++drawCalls; record(eCommand::Draw, startOffset, count); }
+        void drawIndexed(uint32_t startIndex, uint32_t count) override { ++drawCalls; record(eCommand::DrawIndexed, startIndex, count); }
+        void userDraw(ogui::UserDrawFn /*userDrawFn*/, void * /*pUserData*/, const uint32_t *viewport) override { record(eCommand::UserDraw, viewport[0], viewport[1], viewport[2], viewport[3]); }
+        void endFrame() override {}
+
+        bool isSameFrame(const RecordingRenderer &other) const { return frameVertices == other.frameVertices && frameCommands == other.frameCommands; }
+
+        ogui::RendererCaps caps;
+        uint64_t frames = 0;
+        uint64_t vertices = 0;
+        uint64_t drawCalls = 0;
+        uint64_t textureBinds = 0;
+        uint64_t textureCreates = 0;
+        uint64_t textureUpdates = 0;
+
+        bool isDrawingText = false;
+        bool isRecording = false;
+        std::vector<uint8_t> frameVertices;  // As submitted, in the renderer's vertex format
+        std::vector<uint32_t> frameCommands; // Each an eCommand followed by its arguments
+
+    private:
+        enum class eCommand : uint32_t
+        {
+            SetIndexData,
+            Scissor,
+            BindTexture,
+            Draw,
+            DrawIndexed,
+            UserDraw
+        };
+
+        void clearFrame()
+        {
+            frameVertices.clear();
+            frameCommands.clear();
+        }
+
+        void recordVertices(const void *pData, size_t size)
+        {
+            if (!isRecording) return;
+            auto offset = frameVertices.size();
+            frameVertices.resize(offset + size);
+            memcpy(frameVertices.data() + offset, pData, size);
+        }
+
+        template<typename... Args>
+        void record(eCommand command, Args... args)
+        {
+            if (!isRecording) return;
+            frameCommands.insert(frameCommands.end(), { (uint32_t)command, (uint32_t)args... });
+        }
+
+        uintptr_t nextTextureId = 0;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ogui/types.h"
+#include <functional>
 #include <memory>
 
 namespace ogui
@@ -8,8 +9,13 @@ namespace ogui
     class IPanel;
     using IPanelRef = std::shared_ptr<IPanel>;
 
+    class Widget;
+    using WidgetRef = std::shared_ptr<Widget>;
+
     class IRenderer;
 
+    static const uint32_t FRAME_STATS_HISTORY_SIZE = 256;
+
     /**
     * @brief ogui context object. Application uses this to add/remove Panels, propagate application events and set themes.
     * */
@@ -24,6 +30,7 @@ namespace ogui
         * @param height: Initial width of the application view.
         * 
         * @note ogui is event driven and will not redraw unless onResize() is called. This is why knowing the initial dimensions state is important.
+        * @note IRenderer::getCaps() is queried here. Optional renderer features are decided for the lifetime of the context.
         * */
         static IContext *create(IRenderer *pRenderer, int width, int height);
 
@@ -57,6 +64,18 @@ namespace ogui
         * */
         virtual void remove(const IPanelRef &pPanel) = 0;
 
+        /**
+        * @brief Starts a batch of changes, like adding many panels to restore a saved layout. Until the matching endUpdate(), add() and remove() don't update the layout. Batches can be nested.
+        * 
+        * @sa UpdateBatch
+        * */
+        virtual void beginUpdate() = 0;
+
+        /**
+        * @brief Ends a batch of changes started with beginUpdate(). When the outermost batch ends, the layout is updated once if anything changed.
+        * */
+        virtual void endUpdate() = 0;
+
         /**
         * @brief Get the current theme.
         * 
@@ -77,13 +96,114 @@ namespace ogui
 
         /**
         * @brief Forces the GUI to redraw. This can be used when a control changes visual state and needs to make sure the GUI will be redrawn.
+        * 
+        * @note Must be called from the thread calling render(). Other threads use postDirty().
         * */
         virtual void setDirty() = 0;
 
+        /**
+        * @brief Forces part of the GUI to redraw. Use this instead of setDirty() when a control knows its bounds, so only the area that changed is redrawn.
+        * 
+        * @param rect: Area to redraw, in pixels. (0,0) is top-left.
+        * 
+        * @sa RendererCaps::partialRedraw
+        * */
+        virtual void setDirty(const Rect &rect) = 0;
+
+        /**
+        * @brief Limits the memory ogui's textures use. When over budget, the least recently used textures that can be rebuilt, like glyph pages and images that got a texture of their own, are destroyed at the start of the next render(). Textures currently on screen are never evicted, so the budget can be exceeded.
+        * 
+        * @param bytes: Budget in bytes. 0, the default, is unlimited.
+        * */
+        virtual void setTextureBudget(uint64_t bytes) = 0;
+
+        /**
+        * @brief Get how much memory ogui's textures currently use.
+        * 
+        * @return Total size of the textures in bytes, 4 bytes per texel.
+        * */
+        virtual uint64_t getTextureMemory() const = 0;
+
+        /**
+        * @brief Set how many threads generate the draw list. Dock zones don't overlap, so they are generated in parallel and appended in dock order. The draw list is the same as with one thread.
+        * 
+        * @param count: Threads, the one calling render() included. 0 or 1, the default, generates everything on the calling thread.
+        * 
+        * @note With more than one thread, Widget::render() of different panels is called at the same time from different threads.
+        * */
+        virtual void setRenderThreads(uint32_t count) = 0;
+
+        /**
+        * @brief Submits frames to the IRenderer from a thread of its own. render() generates the frame and hands it over without waiting, so a slow submit or a vsync wait in the renderer doesn't delay input handling. When frames come faster than the renderer takes them, only the newest one is submitted, the others are dropped.
+        * 
+        * @param enabled: True to start the thread. False stops it, after it submitted the last frame, and render() submits again.
+        * 
+        * @note While enabled, every frame is a full redraw, RendererCaps::partialRedraw only changes which beginFrame() is called. IRenderer's texture, draw and frame methods, and user draw callbacks, are called from the submit thread. rasterizeGlyph(), getKerning() and loadImage() are still called from the thread calling render(), while the submit thread draws.
+        * */
+        virtual void setSubmitThread(bool enabled) = 0;
+
+        /**
+        * @brief Get the timings and counters of the last frame submitted to the renderer.
+        * 
+        * @return Stats of the last frame. All 0 before the first frame.
+        * 
+        * @sa FrameStats
+        * */
+        virtual const FrameStats &getFrameStats() const = 0;
+
+        /**
+        * @brief Get the stats of the most recent frames, to compute percentiles or plot frame times.
+        * 
+        * @param pStats: Receives up to maxCount stats, oldest first.
+        * @param maxCount: Size of pStats. The context keeps the last FRAME_STATS_HISTORY_SIZE frames.
+        * 
+        * @return How many stats were written in pStats.
+        * */
+        virtual uint32_t getFrameStatsHistory(FrameStats *pStats, uint32_t maxCount) const = 0;
+
+    public:
+        //---------------------------------
+        //--- Posted from other threads ---
+        //---------------------------------
+        // Background work, like an import reporting progress or a build appending to a log, posts what changed. It is
+        // handled at the next render(), on the thread calling it. A target posted again before then is handled once.
+
+        /**
+        * @brief Thread-safe setDirty(). The GUI redraws at the next render().
+        * */
+        virtual void postDirty() = 0;
+
+        /**
+        * @brief Thread-safe way to redraw a panel. At the next render(), its widgets are laid out and drawn again. Widgets are only measured again if they were invalidated.
+        * 
+        * @param pPanel: Panel to redraw. Nothing happens if it was removed from the context by then.
+        * */
+        virtual void postInvalidate(const IPanelRef &pPanel) = 0;
+
+        /**
+        * @brief Thread-safe Widget::invalidate(). At the next render(), the widget is measured, arranged and drawn again.
+        * 
+        * @param pWidget: Widget that changed. Only a weak reference is kept, nothing happens if it is destroyed by then.
+        * 
+        * @note The widget's data must still be safe to read from render() while the background thread changes it.
+        * */
+        virtual void postInvalidate(const WidgetRef &pWidget) = 0;
+
+        /**
+        * @brief Set a function called when something is posted, so an Application blocking on its events wakes up and calls render(). Only the first post after a render() calls it, however many follow.
+        * 
+        * @param callback: Called from the posting thread, it must be thread-safe. Pushing an event to the Application's event queue is typical, see the README. Can be null.
+        * 
+        * @note The callback must not call render() itself, it runs on whatever thread posted.
+        * */
+        virtual void setWakeCallback(const std::function<void()> &callback) = 0;
+
     public:
         //--------------------------
         //--- Application events ---
         //--------------------------
+        // Events are queued and handled at the next render(), so a fast mouse or a live resize costs one update per
+        // frame. Consecutive moves, scrolls and resizes are merged, button and key events keep their order.
 
         /**
         * @brief Application must call this when the Application view changed size.
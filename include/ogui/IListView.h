@@ -0,0 +1,67 @@
+#pragma once
+
+#include "ogui/Widget.h"
+#include <memory>
+#include <string>
+
+namespace ogui
+{
+    /**
+    * @brief Application inherits from this to provide the items of an IListView. Items are only queried when they become visible, so the list can be as long as needed.
+    * */
+    class IListDataSource
+    {
+    public:
+        /**
+        * @brief Destructor
+        * */
+        virtual ~IListDataSource() {}
+
+        /**
+        * @brief Get how many items there are.
+        *
+        * @return Item count.
+        * */
+        virtual uint32_t getCount() const = 0;
+
+        /**
+        * @brief Get the text of an item. Called when the item scrolls into view, or after IListView::refresh().
+        *
+        * @param index: Index of the item, less than getCount().
+        * @param text: Set to the item's text. It comes in with the content of a recycled row, its memory can be reused.
+        * */
+        virtual void getText(uint32_t index, std::string &text) const = 0;
+    };
+
+    class IListView;
+    using IListViewRef = std::shared_ptr<IListView>;
+
+    /**
+    * @brief Virtualized list. Only the rows intersecting the visible part of the panel are laid out and drawn, and their row objects are recycled while scrolling. Memory and frame time don't depend on the item count.
+    * */
+    class IListView : public Widget
+    {
+    public:
+        /**
+        * @brief Creates a list view. Add it to a panel to show it.
+        *
+        * @param pDataSource: Items to show. The Application keeps ownership and must keep it alive as long as the list uses it.
+        * */
+        static IListViewRef create(IListDataSource *pDataSource);
+
+        /**
+        * @brief Set a different data source.
+        *
+        * @param pDataSource: Items to show. Can be null for an empty list.
+        * */
+        virtual void setDataSource(IListDataSource *pDataSource) = 0;
+
+        /**
+        * @brief Application must call this when items were added, removed or changed. The count and the visible items are queried again.
+        * */
+        virtual void refresh() = 0;
+
+    protected:
+        IListView() {}
+    };
+}
@@ -47,7 +47,7 @@ namespace ogui
         virtual void clear() = 0;
 
         /**
-        * @brief Adds a widget to the panel.
+        * @brief Adds a widget at the end of the panel. A widget can only be in a panel once, adding it again moves it.
         * 
         * @param pWidget: The widget to add.
         * */
@@ -57,7 +57,7 @@ namespace ogui
         * @brief Inserts a widget before another one. Widgets in the panel follow a strict draw and alignement order.
         * 
         * @param pWidget: The widget to insert.
-        * @param pBefore: The widget already present in the panel which will insert before.
+        * @param pBefore: The widget already present in the panel which will insert before. If it is not in the panel, pWidget is added at the end.
         * */
         virtual void insertBefore(const WidgetRef &pWidget, const WidgetRef &pBefore) = 0;
 
@@ -65,7 +65,7 @@ namespace ogui
         * @brief Inserts a widget after another one. Widgets in the panel follow a strict draw and alignement order.
         * 
         * @param pWidget: The widget to insert.
-        * @param pAfter: The widget already present in the panel which will insert after.
+        * @param pAfter: The widget already present in the panel which will insert after. If it is not in the panel, pWidget is added at the end.
         * */
         virtual void insertAfter(const WidgetRef &pWidget, const WidgetRef &pAfter) = 0;
 
@@ -75,6 +75,34 @@ namespace ogui
         * @param pWidget: The widget to remove.
         * */
         virtual void remove(const WidgetRef &pWidget) = 0;
+
+        /**
+        * @brief Starts a batch of changes, like filling the panel with many widgets. Until the matching endUpdate(), adding, inserting, removing widgets and setting the title don't update the layout. Batches can be nested.
+        * 
+        * @sa UpdateBatch
+        * */
+        virtual void beginUpdate() = 0;
+
+        /**
+        * @brief Ends a batch of changes started with beginUpdate(). When the outermost batch ends, the layout is updated once if anything changed.
+        * */
+        virtual void endUpdate() = 0;
+
+        /**
+        * @brief Scrolls the panel's widgets. Only what ends up in view is laid out and drawn.
+        * 
+        * @param scrollOffset: How many pixels the content moves up. Clamped to the content's height when the panel is next rendered.
+        * 
+        * @note In double, so a list of millions of rows can be scrolled to any row exactly.
+        * */
+        virtual void setScrollOffset(double scrollOffset) = 0;
+
+        /**
+        * @brief Get how far the panel is scrolled.
+        * 
+        * @return Scroll offset in pixels.
+        * */
+        virtual double getScrollOffset() const = 0;
         
     protected:
         IPanel() {}
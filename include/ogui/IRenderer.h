@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ogui/types.h"
+#include <string>
+#include <vector>
 
 namespace ogui
 {
@@ -10,6 +12,52 @@ namespace ogui
     class IRenderer
     {
     public:
+        /**
+        * @brief Optional features the Application's renderer supports. This is queried once in IContext::create(). Default implementation opts into nothing and ogui will only use the mandatory methods.
+        * 
+        * @return Supported features.
+        * 
+        * @sa RendererCaps
+        * */
+        virtual RendererCaps getCaps() const { return RendererCaps(); }
+
+        /**
+        * @brief ogui needs the pixels of an image referenced by the Theme, like icons. ogui packs them into its own textures and only calls this once per file. Optional, images are not drawn if the Application doesn't implement it.
+        * 
+        * @param filename: File name, as set in the Theme.
+        * @param width: Set to the image width.
+        * @param height: Set to the image height.
+        * @param pixels: Filled with the image data in format RGBA. Total size is width * height * 4.
+        * 
+        * @return True if the image was loaded.
+        * */
+        virtual bool loadImage(const std::string & /*filename*/, uint32_t & /*width*/, uint32_t & /*height*/, std::vector<uint8_t> & /*pixels*/) { return false; }
+
+        /**
+        * @brief ogui needs a glyph to be rasterized. ogui caches the result in its own textures, and only calls this once per font, size and character. Optional, if the Application doesn't implement it, text is measured with a fixed advance and not drawn.
+        * 
+        * @param font: Font name, as set in Theme::font.
+        * @param fontSize: Font size in pixels. This is also the line height.
+        * @param codepoint: Unicode code point of the character.
+        * @param metrics: Filled with the glyph metrics.
+        * @param pixels: Filled with the glyph bitmap in format RGBA. Total size is metrics.width * metrics.height * 4. Glyphs should be white, with coverage in alpha, so ogui can tint them.
+        * 
+        * @return True if the glyph was rasterized.
+        * */
+        virtual bool rasterizeGlyph(const std::string & /*font*/, float /*fontSize*/, uint32_t /*codepoint*/, GlyphMetrics & /*metrics*/, std::vector<uint8_t> & /*pixels*/) { return false; }
+
+        /**
+        * @brief Kerning between two characters. ogui caches the result and only calls this once per font, size and pair. Optional.
+        * 
+        * @param font: Font name, as set in Theme::font.
+        * @param fontSize: Font size in pixels.
+        * @param left: Unicode code point of the first character.
+        * @param right: Unicode code point of the character following it.
+        * 
+        * @return Offset added to the pen position between the two characters, in pixels.
+        * */
+        virtual float getKerning(const std::string & /*font*/, float /*fontSize*/, uint32_t /*left*/, uint32_t /*right*/) { return 0.0f; }
+
         /**
         * @brief ogui needs a texture to be created.
         * 
@@ -37,6 +85,21 @@ namespace ogui
         * */
         virtual uintptr_t updateTexture(uintptr_t textureId, uint32_t width, uint32_t height, uint8_t *pData) = 0;
 
+        /**
+        * @brief ogui requests to update a sub-rectangle of an existing texture. Only called if RendererCaps::textureRegionUpdate is set, updateTexture() is used otherwise. The texture keeps its size and identifier.
+        * 
+        * @param textureId: Texture identifier that should be recognized by the application.
+        * @param x: Left of the region, in pixels.
+        * @param y: Top of the region, in pixels.
+        * @param width: Region width
+        * @param height: Region height
+        * @param stride: Bytes between the start of two rows in pData.
+        * @param pData: Region data in format RGBA. Points to the region's top-left pixel. Each row is width * 4 bytes, rows are stride bytes apart.
+        * 
+        * @note This is always called before beginFrame()
+        * */
+        virtual void updateTextureRegion(uintptr_t /*textureId*/, uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/, uint32_t /*stride*/, const uint8_t * /*pData*/) {}
+
         /**
         * @brief ogui doesn't need a texture anymore. The Application is free to destroy it.
         * 
@@ -51,6 +114,14 @@ namespace ogui
         * */
         virtual void beginFrame() = 0; // Called first
 
+        /**
+        * @brief Begin a partial rendering. Only called if RendererCaps::partialRedraw is set, in which case it replaces beginFrame(). Only the damaged areas are redrawn, each under its own scissor. The Application must preserve the previous frame outside of them and should only clear inside them. The damage list can also be used to present only the parts of the screen that changed.
+        * 
+        * @param pDamageRects: Areas that will be redrawn this frame, in pixels. They never overlap.
+        * @param count: How many rects there are.
+        * */
+        virtual void beginFrame(const Rect * /*pDamageRects*/, uint32_t /*count*/) { beginFrame(); }
+
         /**
         * @brief Sets the vertex data for the ogui rendering. This vertex buffer should also be bound to the graphic API. It will be used for subsequent draw calls.
         * 
@@ -63,6 +134,28 @@ namespace ogui
         * */
         virtual void setVertexData(const Vertex *pData, uint32_t count) = 0;
 
+        /**
+        * @brief Sets the vertex data in the compact layout. Only called if RendererCaps::vertexFormat is eVertexFormat::Compact, in which case it replaces setVertexData(const Vertex *, count).
+        * 
+        * @param pData: Pointer to the first CompactVertex of the array.
+        * @param count: How many vertices there are. Total buffer size is sizeof(CompactVertex) * count.
+        * 
+        * @note Positions are integers in pixels. UVs are unsigned normalized 16 bits, and color is the same as Vertex::color.
+        * 
+        * @sa CompactVertex
+        * */
+        virtual void setVertexData(const CompactVertex * /*pData*/, uint32_t /*count*/) {}
+
+        /**
+        * @brief Sets the index data used by drawIndexed(). This index buffer should also be bound to the graphic API. Only called if RendererCaps::indexedDraw is set.
+        * 
+        * @param pData: Pointer to the first index of the array. Indices are 32 bits.
+        * @param count: How many indices there are. Total buffer size is sizeof(uint32_t) * count.
+        * 
+        * @note The content is static: every quad is 2 triangles (0, 1, 2, 2, 3, 0) offset by 4 vertices. ogui only calls this right after setVertexData() when the buffer had to grow, the Application must keep the last index data for the following frames.
+        * */
+        virtual void setIndexData(const uint32_t * /*pData*/, uint32_t /*count*/) {}
+
         /**
         * @brief Set graphics scissor rect.
         * 
@@ -93,6 +186,14 @@ namespace ogui
         * */
         virtual void draw(uint32_t startOffset, uint32_t count) = 0;
 
+        /**
+        * @brief Asks the Application to draw indexed triangles. Only called if RendererCaps::indexedDraw is set, in which case draw() is never called.
+        * 
+        * @param startIndex: Index offset from the bound index buffer. @see setIndexData
+        * @param count: How many indices to draw.
+        * */
+        virtual void drawIndexed(uint32_t /*startIndex*/, uint32_t /*count*/) {}
+
         /**
         * @brief Custom draw call inserted by the Application. This can be useful to draw the content of a viewport.
         * 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ogui/IRenderer.h"
+
+namespace ogui
+{
+    /**
+    * @brief CPU implementation of IRenderer. Rasterizes into an RGBA framebuffer in memory, without any graphics API or driver. This can be used for headless tools, screenshot tests, or to measure ogui's own cost.
+    * 
+    * @note Textures are point sampled and alpha blended over the framebuffer. Rasterization is split in tiles across threads, the result doesn't depend on the thread count.
+    * */
+    class ISoftwareRenderer : public IRenderer
+    {
+    public:
+        /**
+        * @brief Creates a software renderer.
+        * 
+        * @param width: Framebuffer width.
+        * @param height: Framebuffer height.
+        * @param threadCount: How many threads rasterize tiles, including the calling thread. 0 uses all hardware threads.
+        * */
+        static ISoftwareRenderer *create(uint32_t width, uint32_t height, uint32_t threadCount = 0);
+
+        /**
+        * @brief Destructor. Application is free to delete this object, after the IContext using it.
+        * */
+        virtual ~ISoftwareRenderer() {}
+
+        /**
+        * @brief Resizes the framebuffer. Content is cleared. The Application should also call IContext::onResize().
+        * 
+        * @param width: New framebuffer width.
+        * @param height: New framebuffer height.
+        * */
+        virtual void resize(uint32_t width, uint32_t height) = 0;
+
+        /**
+        * @brief Get the framebuffer content. It is complete after IContext::render() returns, when frames are submitted by render().
+        * 
+        * @note With IContext::setSubmitThread(true), the submit thread draws into the framebuffer while the Application runs, and render() returns before the frame is drawn. Pixels are only stable after IContext::setSubmitThread(false), which returns once the last frame was drawn.
+        * 
+        * @return Pixels in format RGBA, row by row from the top. Total size is width * height * 4.
+        * */
+        virtual const uint8_t *getPixels() const = 0;
+
+        /**
+        * @brief Get the framebuffer width.
+        * */
+        virtual uint32_t getWidth() const = 0;
+
+        /**
+        * @brief Get the framebuffer height.
+        * */
+        virtual uint32_t getHeight() const = 0;
+
+    protected:
+        ISoftwareRenderer() {}
+    };
+}
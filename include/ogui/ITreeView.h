@@ -0,0 +1,122 @@
+#pragma once
+
+#include "ogui/Widget.h"
+#include <memory>
+#include <string>
+
+namespace ogui
+{
+    /**
+    * @brief Parent of the top level items in ITreeDataSource.
+    * */
+    static const uint64_t TREE_ROOT = 0xFFFFFFFFFFFFFFFF;
+
+    /**
+    * @brief Application inherits from this to provide the items of an ITreeView. Items are identified by a value the Application chooses, like an index or a pointer. Only the children of expanded items that are visible get queried.
+    * */
+    class ITreeDataSource
+    {
+    public:
+        /**
+        * @brief Destructor
+        * */
+        virtual ~ITreeDataSource() {}
+
+        /**
+        * @brief Get how many children an item has.
+        *
+        * @param item: Item, or TREE_ROOT for the top level.
+        *
+        * @return Child count.
+        * */
+        virtual uint32_t getChildCount(uint64_t item) const = 0;
+
+        /**
+        * @brief Get a child of an item.
+        *
+        * @param item: Item, or TREE_ROOT for the top level.
+        * @param index: Index of the child, less than getChildCount(item).
+        *
+        * @return The child item.
+        * */
+        virtual uint64_t getChild(uint64_t item, uint32_t index) const = 0;
+
+        /**
+        * @brief Get the text of an item. Called when the item scrolls into view, or after ITreeView::refresh().
+        *
+        * @param item: The item.
+        * @param text: Set to the item's text. It comes in with the content of a recycled row, its memory can be reused.
+        * */
+        virtual void getText(uint64_t item, std::string &text) const = 0;
+    };
+
+    class ITreeView;
+    using ITreeViewRef = std::shared_ptr<ITreeView>;
+
+    /**
+    * @brief Virtualized tree. Rows are the items whose parents are all expanded. Only the rows intersecting the visible part of the panel are laid out and drawn, and their row objects are recycled while scrolling. Memory depends on how many items are expanded, not on the item count.
+    * */
+    class ITreeView : public Widget
+    {
+    public:
+        /**
+        * @brief Creates a tree view. Add it to a panel to show it.
+        *
+        * @param pDataSource: Items to show. The Application keeps ownership and must keep it alive as long as the tree uses it.
+        * */
+        static ITreeViewRef create(ITreeDataSource *pDataSource);
+
+        /**
+        * @brief Set a different data source. Every item is collapsed.
+        *
+        * @param pDataSource: Items to show. Can be null for an empty tree.
+        * */
+        virtual void setDataSource(ITreeDataSource *pDataSource) = 0;
+
+        /**
+        * @brief Application must call this when items were added, removed or changed. Expanded items that are not at the same place anymore are collapsed.
+        * */
+        virtual void refresh() = 0;
+
+        /**
+        * @brief Get how many rows the tree currently shows, all the way down through expanded items.
+        *
+        * @return Row count.
+        * */
+        virtual uint32_t getRowCount() const = 0;
+
+        /**
+        * @brief Get the item shown at a row.
+        *
+        * @param row: Row index, less than getRowCount().
+        *
+        * @return The item.
+        * */
+        virtual uint64_t getItem(uint32_t row) const = 0;
+
+        /**
+        * @brief Expands or collapses the item shown at a row. Collapsing an item also collapses its descendants.
+        *
+        * @param row: Row index, less than getRowCount().
+        * @param expanded: True to show the item's children.
+        * */
+        virtual void setExpanded(uint32_t row, bool expanded) = 0;
+
+        /**
+        * @brief Get if the item shown at a row is expanded.
+        *
+        * @param row: Row index, less than getRowCount().
+        *
+        * @return True if the item's children are shown.
+        * */
+        virtual bool isExpanded(uint32_t row) const = 0;
+
+        /**
+        * @brief Collapses every item.
+        * */
+        virtual void collapseAll() = 0;
+
+    protected:
+        ITreeView() {}
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+namespace ogui
+{
+    /**
+    * @brief Starts or stops recording ogui's internal trace zones. Recording is off by default.
+    * 
+    * @param enabled: True to record.
+    * 
+    * @note Each thread records into its own ring buffer, the most recent zones overwrite the oldest ones.
+    * @note Tracing can be compiled out with the OGUI_TRACE CMake option. Then nothing is ever recorded.
+    * */
+    void setTraceEnabled(bool enabled);
+
+    /**
+    * @brief Get whether trace zones are being recorded.
+    * */
+    bool isTraceEnabled();
+
+    /**
+    * @brief Dumps the zones currently in the ring buffers of all threads as Chrome trace event JSON. Open it with chrome://tracing or ui.perfetto.dev.
+    * 
+    * @return A JSON object with a "traceEvents" array of complete ("X") events.
+    * 
+    * @note Timestamps are std::chrono::steady_clock microseconds, so they line up with application traces using the same clock.
+    * @note Safe to call from any thread while other threads are recording.
+    * */
+    std::string getChromeTrace();
+
+    /**
+    * @brief Discards every recorded zone.
+    * 
+    * @note Must not be called while other threads are recording.
+    * */
+    void clearTrace();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace ogui
+{
+    /**
+    * @brief Scoped batch of changes on an ogui::IContext or an ogui::IPanel. Calls beginUpdate() when constructed and endUpdate() when destroyed, so the layout is updated once when the scope exits, even if it exits with an exception.
+    * 
+    * @note Usage: { ogui::UpdateBatch<ogui::IPanel> batch(*pPanel); for (const auto &pRow : rows) pPanel->add(pRow); }
+    * */
+    template<typename T>
+    class UpdateBatch final
+    {
+    public:
+        explicit UpdateBatch(T &in_target) : target(in_target) { target.beginUpdate(); }
+        ~UpdateBatch() { target.endUpdate(); }
+
+        UpdateBatch(const UpdateBatch &) = delete;
+        UpdateBatch &operator=(const UpdateBatch &) = delete;
+
+    private:
+        T &target;
+    };
+}
@@ -1,9 +1,119 @@
 #pragma once
 
+#include "ogui/types.h"
+
 namespace ogui
 {
+    class Context;
+    class Panel;
+
+    /**
+    * @brief Base of everything a panel holds. Widgets are laid out top to bottom in the panel's client area, in the order of the panel, and scroll with it.
+    * 
+    * @note Layout is done in two passes. measure() asks each widget the size it needs, then arrange() places it. Both are cached: a widget is only measured again after invalidate(), or when its available width or the theme changed, and only arranged again when its rect or the visible part of it changed.
+    * */
     class Widget
     {
     public:
+        /**
+        * @brief Destructor
+        * */
+        virtual ~Widget() {}
+
+        /**
+        * @brief Get where the widget was last laid out.
+        *
+        * @return Rect in pixels. (0,0) is top-left of the view. Can be outside of the panel when scrolled out of view. Scrolling only arranges the widgets coming into or going out of view, the others keep their last rect until they are back or the panel's content changes.
+        * */
+        const Rect &getRect() const { return rect; }
+
+        /**
+        * @brief Get where the widget's top was last laid out, exactly. getRect().y is a float, it can't place every row of a list millions of pixels tall. Widgets that tall position their content from this instead.
+        *
+        * @return Y in pixels. (0,0) is top-left of the view. Set before arrange() is called.
+        * */
+        double getTop() const { return top; }
+
+        /**
+        * @brief Tells the panel holding the widget that the widget's content changed. The widget is measured and arranged again, and redrawn on the next render.
+        * 
+        * @note Must be called from the thread calling IContext::render(). Other threads use IContext::postInvalidate().
+        * */
+        void invalidate();
+
+        /**
+        * @brief Called by ogui to know the size the widget needs.
+        *
+        * @param pContext: Context of the panel.
+        * @param available: Space the panel can give. Height is infinite, panels scroll.
+        *
+        * @return Size in pixels. The panel gives the widget its whole available width, and the height it asked for.
+        * */
+        virtual Vec2 measure(Context * /*pContext*/, const Vec2 & /*available*/) { return { 0.0f, 0.0f }; }
+
+        /**
+        * @brief Called by ogui to place the widget.
+        *
+        * @param pContext: Context of the panel.
+        * @param rect: Where the widget goes.
+        * @param viewport: Visible part of the panel. Widgets with a lot of content only need to lay out what intersects it.
+        * */
+        virtual void arrange(Context *pContext, const Rect &rect, const Rect &viewport);
+
+        /**
+        * @brief Called by ogui to draw the widget. Drawing is clipped to the panel.
+        *
+        * @param pContext: Context of the panel.
+        *
+        * @note Can be called from another thread than render()'s, see IContext::setRenderThreads(). Widgets of the same panel are always drawn on the same thread, one after the other. The widget and its data must not change while it draws.
+        * */
+        virtual void render(Context * /*pContext*/) {}
+
+        /**
+        * @brief Called by ogui when a mouse button is pressed over the widget.
+        *
+        * @param pContext: Context of the panel.
+        * @param button: Mouse button. 0 = left, 1 = right, 2 = middle, ...
+        * @param position: Cursor in pixels. (0,0) is top-left of the view.
+        * */
+        virtual void onMouseButtonDown(Context * /*pContext*/, int /*button*/, const Vec2 & /*position*/) {}
+
+        /**
+        * @brief Called by ogui when the mouse moves over the widget, or the widget scrolls under the mouse. The first call after onMouseLeave() means the mouse entered it.
+        *
+        * @param pContext: Context of the panel.
+        * @param position: Cursor in pixels. (0,0) is top-left of the view.
+        * */
+        virtual void onMouseMove(Context * /*pContext*/, const Vec2 & /*position*/) {}
+
+        /**
+        * @brief Called by ogui when the mouse is no longer over the widget, or the widget is removed from its panel while hovered.
+        *
+        * @param pContext: Context of the panel.
+        * */
+        virtual void onMouseLeave(Context * /*pContext*/) {}
+
+    protected:
+        Rect rect = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    private:
+        friend class Panel;
+
+        const Vec2 &measureCached(Context *pContext, const Vec2 &available);
+        void arrangeCached(Context *pContext, const Rect &rect, double top, const Rect &viewport);
+
+        Panel *pPanel = nullptr; // Panel holding the widget
+        double top = 0.0;
+        uint32_t version = 0; // Incremented by invalidate()
+
+        // What the last measure() and arrange() were given
+        uint32_t measuredVersion = 0xFFFFFFFF;
+        uint32_t measuredThemeVersion = 0xFFFFFFFF;
+        float measuredWidth = 0.0f;
+        Vec2 measuredSize = { 0.0f, 0.0f };
+        bool isArranged = false;
+        Rect arrangedRect = { 0.0f, 0.0f, 0.0f, 0.0f };
+        double arrangedTop = 0.0;
+        Rect arrangedVisibleRect = { 0.0f, 0.0f, 0.0f, 0.0f };
     };
 }
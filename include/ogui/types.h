@@ -27,6 +27,83 @@ namespace ogui
         uint32_t color;
     };
 
+    /**
+    * @brief 12 bytes vertex, for renderers where vertex upload bandwidth matters more than precision.
+    * 
+    * @sa RendererCaps::vertexFormat
+    * */
+    struct CompactVertex
+    {
+        int16_t x, y;   // Position in pixels, rounded to the nearest pixel.
+        uint16_t u, v;  // Texture coordinates, normalized. 0xFFFF is 1.0.
+        uint32_t color;
+    };
+
+    /**
+    * @brief Vertex layout sent to IRenderer::setVertexData.
+    * */
+    enum class eVertexFormat
+    {
+        Float,  // Vertex
+        Compact // CompactVertex
+    };
+
+    /**
+    * @brief Metrics of a rasterized glyph.
+    * 
+    * @sa IRenderer::rasterizeGlyph
+    * */
+    struct GlyphMetrics
+    {
+        float advance = 0.0f;   // How much the pen moves right after this glyph, in pixels.
+        int32_t offsetX = 0;    // Where the bitmap's left is, relative to the pen position.
+        int32_t offsetY = 0;    // Where the bitmap's top is, relative to the top of the line.
+        uint32_t width = 0;     // Bitmap width. Can be 0 for glyphs with nothing to draw, like spaces.
+        uint32_t height = 0;    // Bitmap height.
+    };
+
+    /**
+    * @brief Optional features a renderer can opt into. ogui queries them once, when the context is created.
+    * 
+    * @sa IRenderer::getCaps
+    * */
+    struct RendererCaps
+    {
+        bool indexedDraw = false; // Renderer implements setIndexData() and drawIndexed(). Quads will be sent as 4 vertices instead of 6.
+        bool partialRedraw = false; // Renderer implements beginFrame(pDamageRects, count) and preserves the previous frame outside of the damaged areas.
+        eVertexFormat vertexFormat = eVertexFormat::Float; // With Compact, the renderer implements setVertexData(const CompactVertex *, count) instead of using the Vertex version.
+        bool textureRegionUpdate = false; // Renderer implements updateTextureRegion(). Only the parts of a texture that changed are uploaded.
+    };
+
+    /**
+    * @brief Timings and counters of one rendered frame. Times are in milliseconds.
+    * 
+    * @note Only collected when ogui is built with OGUI_STATS (the default). Otherwise every field stays 0.
+    * 
+    * @sa IContext::getFrameStats
+    * */
+    struct FrameStats
+    {
+        uint64_t frameIndex = 0;        // Increments for every frame submitted to the renderer.
+        float frameTime = 0.0f;         // Whole IContext::render() call, texture uploads included.
+        float textureTime = 0.0f;       // Processing the texture create/update/destroy queues.
+        float layoutTime = 0.0f;        // Layout updates since the previous frame, in render() for input and outside of it for other changes.
+        float inputTime = 0.0f;         // Handling the input events queued since the previous frame, the layout they caused included.
+        float inputLatency = 0.0f;      // Longest wait of an input event in the queue, from when it was received to when it was handled.
+        float generateTime = 0.0f;      // Building the draw list.
+        float submitTime = 0.0f;        // Calls into IRenderer, from beginFrame() to endFrame(). With a submit thread, handing the frame over to it.
+        uint32_t vertexCount = 0;
+        uint32_t drawCallCount = 0;
+        uint32_t textureBindCount = 0;
+        uint32_t textureCreateCount = 0;
+        uint32_t textureUpdateCount = 0;
+        uint32_t textureDestroyCount = 0;
+        uint64_t bytesUploaded = 0;     // Texture data passed to createTexture() and updateTexture().
+        uint32_t inputEventCount = 0;   // Input events received from the Application.
+        uint32_t inputHandledCount = 0; // Input events handled, after consecutive moves, scrolls and resizes were merged.
+        uint32_t droppedFrameCount = 0; // With a submit thread, 1 when the previous frame was replaced by this one before the thread submitted it.
+    };
+
     struct Theme
     {
         std::string font;
@@ -0,0 +1,224 @@
+#include "Atlas.h"
+#include "Font.h"
+#include "ogui/IRenderer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace ogui
+{
+    static const uint32_t PADDING = 1; // Keeps bilinear filtering from bleeding between regions
+
+    Atlas::Atlas(Context *in_pContext, uint32_t in_pageSize)
+        : pContext(in_pContext)
+        , pageSize(in_pageSize)
+    {
+        const uint8_t whitePixels[2 * 2 * 4] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+        };
+        add(2, 2, whitePixels, &white);
+
+        // Sample the center of the block so filtering never reaches a neighbour
+        white.uv.x += white.uv.w * 0.5f;
+        white.uv.y += white.uv.h * 0.5f;
+        white.uv.w = 0.0f;
+        white.uv.h = 0.0f;
+    }
+
+    Atlas::~Atlas()
+    {
+    }
+
+    bool Atlas::add(uint32_t width, uint32_t height, const uint8_t *pData, AtlasRegion *pRegion)
+    {
+        if (!width || !height || !pData || !pRegion) return false;
+
+        uint32_t x = 0, y = 0;
+        Page *pPage = nullptr;
+        for (const auto &pCandidate : pages)
+        {
+            if (insert(*pCandidate, width, height, &x, &y))
+            {
+                pPage = pCandidate.get();
+                break;
+            }
+        }
+
+        if (!pPage)
+        {
+            // Images bigger than a page get a page of their own
+            auto size = pageSize;
+            while (size < width + PADDING || size < height + PADDING) size *= 2;
+            pPage = addPage(size);
+            if (!insert(*pPage, width, height, &x, &y)) return false;
+        }
+
+        for (uint32_t row = 0; row < height; ++row)
+        {
+            memcpy(pPage->pixels.data() + ((y + row) * pPage->size + x) * 4, pData + row * width * 4, width * 4);
+        }
+
+        pContext->pTextureManager->updateRegion(*pPage->texture, x, y, width, height);
+
+        auto invSize = 1.0f / (float)pPage->size;
+        pRegion->pTexture = pPage->texture.get();
+        pRegion->x = x;
+        pRegion->y = y;
+        pRegion->width = width;
+        pRegion->height = height;
+        pRegion->uv = { (float)x * invSize, (float)y * invSize, (float)width * invSize, (float)height * invSize };
+
+        return true;
+    }
+
+    const AtlasRegion *Atlas::getImage(const std::string &filename)
+    {
+        if (filename.empty()) return nullptr;
+
+        auto it = images.find(filename);
+        if (it == images.end())
+        {
+            if (!pContext->canLoad()) return nullptr;
+
+            // Failures are remembered too, so we don't try to load it every frame
+            AtlasRegion region;
+            uint32_t width = 0, height = 0;
+            std::vector<uint8_t> pixels;
+            if (pContext->pRenderer->loadImage(filename, width, height, pixels) && pixels.size() >= width * height * 4)
+            {
+                add(width, height, pixels.data(), &region);
+            }
+            it = images.insert({ filename, region }).first;
+        }
+
+        return it->second.pTexture ? &it->second : nullptr;
+    }
+
+    Atlas::Page *Atlas::addPage(uint32_t size)
+    {
+        auto pPage = new Page();
+        pPage->size = size;
+        pPage->pixels.resize(size * size * 4, 0);
+        pPage->skyline.push_back({ 0, 0, size });
+
+        // The first page holds the white texel and theme images. Others can be rebuilt lazily, when over the texture budget.
+        auto isCacheable = !pages.empty();
+        pPage->texture = pContext->pTextureManager->create(size, size, pPage->pixels.data(), isCacheable, [this, pPage]() { evictPage(pPage); });
+        pages.emplace_back(pPage);
+
+        return pPage;
+    }
+
+    void Atlas::evictPage(Page *pPage)
+    {
+        // Images and glyphs on this page will be loaded again the next time they are needed
+        auto pTexture = pPage->texture.get();
+        for (auto it = images.begin(); it != images.end();)
+        {
+            if (it->second.pTexture == pTexture) it = images.erase(it);
+            else ++it;
+        }
+        for (auto pFont : pContext->fonts) pFont->evict(pTexture);
+        assert(!isReferenced(pTexture) && "Atlas page evicted while a region still points into it.");
+
+        // The texture outlives the page until its destruction is flushed. Its pixels go with the page.
+        pTexture->pData = nullptr;
+        pages.erase(std::find_if(pages.begin(), pages.end(), [pPage](const std::unique_ptr<Page> &pOther) { return pOther.get() == pPage; }));
+    }
+
+    bool Atlas::isReferenced(const Texture *pTexture) const
+    {
+        if (white.pTexture == pTexture) return true;
+        for (const auto &image : images)
+        {
+            if (image.second.pTexture == pTexture) return true;
+        }
+        for (auto pFont : pContext->fonts)
+        {
+            if (pFont->references(pTexture)) return true;
+        }
+        return false;
+    }
+
+    bool Atlas::fit(const Page &page, size_t index, uint32_t width, uint32_t height, uint32_t *pY) const
+    {
+        // Find the highest skyline segment under the span [x, x + width)
+        auto x = page.skyline[index].x;
+        if (x + width > page.size) return false;
+
+        uint32_t y = 0;
+        for (auto widthLeft = (int64_t)width; widthLeft > 0; ++index)
+        {
+            if (index >= page.skyline.size()) return false;
+            y = std::max(y, page.skyline[index].y);
+            if (y + height > page.size) return false;
+            widthLeft -= page.skyline[index].width;
+        }
+
+        *pY = y;
+        return true;
+    }
+
+    bool Atlas::insert(Page &page, uint32_t width, uint32_t height, uint32_t *pX, uint32_t *pY)
+    {
+        auto paddedWidth = width + PADDING;
+        auto paddedHeight = height + PADDING;
+
+        // Bottom-left: lowest resulting top, then narrowest segment
+        size_t bestIndex = std::numeric_limits<size_t>::max();
+        uint32_t bestY = std::numeric_limits<uint32_t>::max();
+        uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+        for (size_t i = 0; i < page.skyline.size(); ++i)
+        {
+            uint32_t y;
+            if (!fit(page, i, paddedWidth, paddedHeight, &y)) continue;
+            if (y + paddedHeight < bestY || (y + paddedHeight == bestY && page.skyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestY = y + paddedHeight;
+                bestWidth = page.skyline[i].width;
+            }
+        }
+        if (bestIndex == std::numeric_limits<size_t>::max()) return false;
+
+        SkylineNode node = { page.skyline[bestIndex].x, bestY, paddedWidth };
+        page.skyline.insert(page.skyline.begin() + bestIndex, node);
+
+        // Shrink or remove the segments now covered by the new node
+        for (auto i = bestIndex + 1; i < page.skyline.size();)
+        {
+            auto &next = page.skyline[i];
+            auto nodeRight = node.x + node.width;
+            if (next.x >= nodeRight) break;
+
+            auto shrink = nodeRight - next.x;
+            if (next.width <= shrink)
+            {
+                page.skyline.erase(page.skyline.begin() + i);
+                continue;
+            }
+            next.x += shrink;
+            next.width -= shrink;
+            break;
+        }
+
+        // Merge neighbours at the same height
+        for (size_t i = 0; i + 1 < page.skyline.size();)
+        {
+            if (page.skyline[i].y == page.skyline[i + 1].y)
+            {
+                page.skyline[i].width += page.skyline[i + 1].width;
+                page.skyline.erase(page.skyline.begin() + i + 1);
+                continue;
+            }
+            ++i;
+        }
+
+        *pX = node.x;
+        *pY = node.y - paddedHeight;
+        return true;
+    }
+}
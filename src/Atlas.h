@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Context.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ogui
+{
+    struct AtlasRegion
+    {
+        Texture *pTexture = nullptr; // Page the region lives in
+        uint32_t x = 0, y = 0, width = 0, height = 0; // In pixels
+        Rect uv = { 0.0f, 0.0f, 0.0f, 0.0f };
+    };
+
+    // Packs images into shared texture pages, so most of the GUI renders with a single texture bound.
+    // Uses a skyline bottom-left packer. When a page is full, a new one is added.
+    class Atlas final
+    {
+    public:
+        Atlas(Context *pContext, uint32_t pageSize);
+        ~Atlas();
+
+        bool add(uint32_t width, uint32_t height, const uint8_t *pData, AtlasRegion *pRegion);
+        const AtlasRegion *getImage(const std::string &filename); // Loaded through IRenderer::loadImage the first time. Null if it failed.
+
+        AtlasRegion white; // 2x2 white texels. Sample white.uv's top-left to draw solid colors.
+
+    private:
+        struct SkylineNode
+        {
+            uint32_t x, y, width;
+        };
+
+        struct Page
+        {
+            std::vector<uint8_t> pixels;
+            std::vector<SkylineNode> skyline;
+            TextureRef texture;
+            uint32_t size;
+        };
+
+        Page *addPage(uint32_t size);
+        void evictPage(Page *pPage);
+        bool isReferenced(const Texture *pTexture) const; // By a region handed out, images and glyphs included
+        bool fit(const Page &page, size_t index, uint32_t width, uint32_t height, uint32_t *pY) const;
+        bool insert(Page &page, uint32_t width, uint32_t height, uint32_t *pX, uint32_t *pY);
+
+        Context *pContext = nullptr;
+        uint32_t pageSize = 1024;
+        std::vector<std::unique_ptr<Page>> pages;
+        std::unordered_map<std::string, AtlasRegion> images;
+    };
+}
@@ -1,15 +1,30 @@
 #include "ogui/IContext.h"
+#include "Atlas.h"
 #include "Context.h"
+#include "Font.h"
+#include "FrameArena.h"
+#include "InputQueue.h"
+#include "JobPool.h"
+#include "RenderThread.h"
 #include "ogui/IRenderer.h"
+#include "ogui/Widget.h"
 #include "Panel.h"
 #include "PanelsManager.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "VertexFormat.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 namespace ogui
 {
-    static uint32_t WHITE = 0xFFFFFFFF;
+    static const size_t MAX_DAMAGE_RECTS = 8;
+    static const size_t MAX_PENDING_DAMAGE_RECTS = 64;
 
     static Color HexToColor(uint32_t hex)
     {
@@ -21,22 +36,31 @@ namespace ogui
         };
     }
 
-    static uint32_t ColorToHex(Color col)
+    static float RectArea(const Rect &rect)
     {
-        uint32_t packed = 0;
-        packed |= ((uint32_t)(col.r * 255.f) << 24) & 0xff000000;
-        packed |= ((uint32_t)(col.g * 255.f) << 16) & 0x00ff0000;
-        packed |= ((uint32_t)(col.b * 255.f) << 8) & 0x0000ff00;
-        packed |= (uint32_t)(col.a * 255.f) & 0x000000ff;
-        return packed;
+        return rect.w * rect.h;
+    }
+
+    static Rect RectUnion(const Rect &a, const Rect &b)
+    {
+        auto x = std::min(a.x, b.x);
+        auto y = std::min(a.y, b.y);
+        return { x, y, std::max(a.x + a.w, b.x + b.w) - x, std::max(a.y + a.h, b.y + b.h) - y };
+    }
+
+    static bool RectIntersects(const Rect &a, const Rect &b)
+    {
+        return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
     }
 
     Context::Context(IRenderer *in_pRenderer, int in_width, int in_height)
         : pRenderer(in_pRenderer)
+        , caps(in_pRenderer->getCaps())
         , width(in_width)
         , height(in_height)
     {
         // Setup default theme
+        theme.fontSize = 14.0f;
         theme.panelMargin = 8.0f;
         theme.panelPadding = 5.0f;
         theme.controlHeight = 26.0f;
@@ -80,20 +104,30 @@ namespace ogui
         theme.disabledTint = { 0.5f, 0.5f, 0.5f, 1.0f };
         theme.headerColor = HexToColor(404553);
 
-        whiteTexture.width = 1;
-        whiteTexture.height = 1;
-        whiteTexture.pData = (uint8_t *)&WHITE;
-        textureToCreate.push_back(&whiteTexture);
+        pFrameArena = new FrameArena();
+        pInputQueue = new InputQueue();
+        pInvalidateQueue = new InvalidateQueue();
+        pTextureManager = new TextureManager(this);
 
-        // Re-usable draw command.
-        drawCmd.command = eDrawCommand::Draw;
+        // White texel, icons and glyphs all share the atlas pages
+        pAtlas = new Atlas(this, 1024);
 
+        pPlaceholderFont = new Font(this, std::string(), 0.0f);
         pPanelsManager = new PanelsManager();
     }
 
     Context::~Context()
     {
+        delete pRenderThread;
         delete pPanelsManager;
+        for (auto pFont : fonts) delete pFont;
+        delete pPlaceholderFont;
+        delete pJobPool;
+        delete pAtlas;
+        delete pTextureManager;
+        delete pFrameArena;
+        delete pInputQueue;
+        delete pInvalidateQueue;
     }
 
     void Context::add(const IPanelRef &pPanel, const IPanelRef &pDockParent, eDockPosition dockPosition)
@@ -103,39 +137,23 @@ namespace ogui
 
         if (!pPanelImpl) return;
 
-        for (const auto &pOwnPanel : panels) if (pOwnPanel == pPanel) return; // Aleady added
+        int index;
+        if (pPanelsManager->find(pPanelImpl, &index) != DOCK_NULL) return; // Aleady added
+        pPanelImpl->pContext = this;
 
-        if (!pDockParentImpl)
+        DockContext dockContext;
+        dockContext.target = pPanelsManager->document_zone;
+        dockContext.position = eDockPanelPosition::Center;
+        if (pDockParentImpl)
         {
-            pPanelsManager->document_zone->panels.push_back(pPanelImpl);
-            pPanelsManager->document_zone->active_panel = (int)pPanelsManager->document_zone->panels.size() - 1;
-        }
-        else
-        {
-            int index;
-            auto pDockZone = pPanelsManager->find(pDockParentImpl, &index);
-            if (pDockZone == nullptr) pDockZone = pPanelsManager->document_zone;
-
-            if (dockPosition == eDockPosition::Center)
-            {
-                pDockZone->panels.push_back(pPanelImpl);
-                pDockZone->active_panel = (int)pDockZone->panels.size() - 1;
-            }
-            else
-            {
-                DockContext dockContext;
-                dockContext.target = pDockZone;
-                dockContext.position = (eDockPanelPosition)dockPosition;
-                dockContext.tab_index = 0;
-                dockContext.amount = 0.5f;
-                dockContext.magnet = eDockMagnet::Middle;
-                dockContext.left_most = true;
-                dockContext.right_most = true;
-                dockContext.top_most = true;
-                dockContext.bottom_most = true;
-                pDockZone->dockPanel(pPanelImpl, dockContext);
-            }
+            auto dockZone = pPanelsManager->find(pDockParentImpl, &index);
+            if (dockZone != DOCK_NULL) dockContext.target = dockZone;
+            dockContext.position = (eDockPanelPosition)dockPosition;
+            dockContext.tab_index = 0;
+            dockContext.amount = 0.5f;
+            dockContext.magnet = eDockMagnet::Middle;
         }
+        pPanelsManager->dockPanel(pPanelImpl, dockContext);
 
         updateLayout();
     }
@@ -145,74 +163,127 @@ namespace ogui
         auto pPanelImpl = std::dynamic_pointer_cast<Panel>(pPanel);
 
         if (!pPanelImpl) return;
-        for (auto it = panels.begin(); it != panels.end(); ++it)
-        {
-            if (*it == pPanelImpl)
-            {
-                panels.erase(it);
-                updateLayout();
-                break;
-            }
-        }
+
+        int index;
+        if (pPanelsManager->find(pPanelImpl, &index) == DOCK_NULL) return;
+        if (pHoveredWidget && pPanelImpl->widgets.contains(pHoveredWidget)) unhover(pHoveredWidget);
+        pPanelsManager->undockPanel(pPanelImpl);
+        pPanelsManager->cleanDock();
+        pPanelImpl->pContext = nullptr;
+
+        updateLayout();
     }
 
-    void Context::render()
+    void Context::beginUpdate()
     {
-        vertices.clear();
-        drawList.clear();
+        ++updateDepth;
+    }
 
-        drawCmd.drawData.vertexStart = 0;
-        drawCmd.drawData.vertexCount = 0;
-        lastBoundTexture = 0;
+    void Context::endUpdate()
+    {
+        if (!updateDepth || --updateDepth) return;
 
-        // Create textures
-        for (auto &textureToCreate : textureToCreate)
+        if (isLayoutPending) updateLayout();
+    }
+
+    void Context::render()
+    {
+        OGUI_TRACE_ZONE("Context::render");
+
+        bool submitted;
         {
-            textureToCreate->id = pRenderer->createTexture(textureToCreate->width, textureToCreate->height, textureToCreate->pData);
+            OGUI_STAT_TIMER(pendingStats.frameTime);
+            pFrameArena->reset();
+            handleInvalidations();
+            handleInput(); // Once per frame, however many events came in
+            submitted = renderFrame();
         }
-        textureToCreate.clear();
+        if (submitted) pushFrameStats();
+    }
+
+    bool Context::renderFrame()
+    {
+        frameTarget.clear();
+
+        // Safe point, nothing references last frame's draw list anymore
+        pTextureManager->collect();
+        updateTextures();
+
+        if (!isDirty) return false;
+        isDirty = false;
 
-        // Update textures
-        for (auto &textureToUpdate : textureToUpdate)
+        // Renderers that can't preserve the previous frame redraw everything. So does the render thread, it can drop
+        // frames, and the next one must cover their damage.
+        auto isPartialRedraw = caps.partialRedraw && !pRenderThread;
+        if (!isPartialRedraw || damageRects.empty())
         {
-            pRenderer->updateTexture(textureToUpdate->id, textureToUpdate->width, textureToUpdate->height, textureToUpdate->pData);
+            damageRects.clear();
+            damageRects.push_back(getRect());
         }
-        textureToUpdate.clear();
+        mergeDamage();
 
-        // Destroy textures
-        for (auto &textureToDestroy : textureToDestroy)
+        // Generate drawlist. Each damaged area redraws what intersects it, under its own scissor.
         {
-            pRenderer->destroyTexture(textureToDestroy->id);
-        }
-        textureToDestroy.clear();
+            OGUI_TRACE_ZONE("Context::generate");
+            OGUI_STAT_TIMER(pendingStats.generateTime);
+            for (const auto &damageRect : damageRects)
+            {
+                currentDamage = damageRect;
+                if (isPartialRedraw) scissor(damageRect);
 
-        if (!isDirty) return;
-        isDirty = false;
+                drawRect(damageRect, theme.windowColor);
 
-        // Generate drawlist
-        bindTexture(whiteTexture);
-        drawRect({ 50, 100, 150, 25 }, { 1, 0, 0, 1 });
-        flush();
+                // Draw panels
+                pPanelsManager->render(this);
+            }
+            flush();
+        }
 
-        // Draw panels
-        pPanelsManager->render(this);
+        // Upload what was added while generating, like newly rasterized glyphs
+        updateTextures();
 
         // Call into the renderer for the actual render
-        pRenderer->beginFrame();
-        pRenderer->setVertexData(vertices.data(), (uint32_t)vertices.size());
+        if (pRenderThread) publishFrame();
+        else submit(frameTarget.vertices, frameTarget.drawList, damageRects, pendingStats, true);
+        damageRects.clear();
+        return true;
+    }
+
+    void Context::submit(const std::vector<Vertex> &vertices, const std::vector<DrawCommand> &drawList, const std::vector<Rect> &damage, FrameStats &stats, bool isTouchingTextures)
+    {
+        OGUI_TRACE_ZONE("Context::submit");
+        OGUI_STAT_TIMER(stats.submitTime);
+        OGUI_STAT(stats.vertexCount = (uint32_t)vertices.size());
+        if (caps.partialRedraw) pRenderer->beginFrame(damage.data(), (uint32_t)damage.size());
+        else pRenderer->beginFrame();
+        if (caps.vertexFormat == eVertexFormat::Compact)
+        {
+            compactVertices.resize(vertices.size());
+            ToCompactVertices(vertices.data(), compactVertices.data(), (uint32_t)vertices.size());
+            pRenderer->setVertexData(compactVertices.data(), (uint32_t)compactVertices.size());
+        }
+        else
+        {
+            pRenderer->setVertexData(vertices.data(), (uint32_t)vertices.size());
+        }
+        if (caps.indexedDraw) updateIndices((uint32_t)vertices.size());
 
         for (const auto &cmd : drawList)
         {
             switch (cmd.command)
             {
                 case ogui::eDrawCommand::Draw:
-                    pRenderer->draw(cmd.drawData.vertexStart, cmd.drawData.vertexCount);
+                    if (caps.indexedDraw) pRenderer->drawIndexed(cmd.drawData.vertexStart / 4 * 6, cmd.drawData.vertexCount / 4 * 6);
+                    else pRenderer->draw(cmd.drawData.vertexStart, cmd.drawData.vertexCount);
+                    OGUI_STAT(++stats.drawCallCount);
                     break;
                 case ogui::eDrawCommand::SetScissor:
                     pRenderer->scissor(cmd.scissorData.x, cmd.scissorData.y, cmd.scissorData.width, cmd.scissorData.height);
                     break;
                 case ogui::eDrawCommand::BindTexture:
-                    pRenderer->bindTexture(cmd.bindTextureData.textureId);
+                    pRenderer->bindTexture(cmd.bindTextureData.pTexture->id);
+                    if (isTouchingTextures) pTextureManager->touch(*cmd.bindTextureData.pTexture);
+                    OGUI_STAT(++stats.textureBindCount);
                     break;
                 case ogui::eDrawCommand::UserDraw:
                     pRenderer->userDraw(cmd.userDrawData.userDrawFn, cmd.userDrawData.pUserData, &cmd.userDrawData.x);
@@ -223,18 +294,217 @@ namespace ogui
         pRenderer->endFrame();
     }
 
+    void Context::publishFrame()
+    {
+        OGUI_TRACE_ZONE("Context::publishFrame");
+        OGUI_STAT_TIMER(pendingStats.submitTime);
+
+        // The frame's buffers are handed over, the packet's old ones are cleared and reused by the next frame
+        auto &packet = pRenderThread->getBackPacket();
+        std::swap(packet.vertices, frameTarget.vertices);
+        std::swap(packet.drawList, frameTarget.drawList);
+        packet.damageRects = damageRects;
+
+        // Eviction reads when textures were last used, so they are touched on this thread. Counted here too.
+        OGUI_STAT(pendingStats.vertexCount = (uint32_t)packet.vertices.size());
+        for (const auto &cmd : packet.drawList)
+        {
+            if (cmd.command == eDrawCommand::BindTexture)
+            {
+                pTextureManager->touch(*cmd.bindTextureData.pTexture);
+                OGUI_STAT(++pendingStats.textureBindCount);
+            }
+            else if (cmd.command == eDrawCommand::Draw)
+            {
+                OGUI_STAT(++pendingStats.drawCallCount);
+            }
+        }
+
+        if (pRenderThread->publish()) OGUI_STAT(++pendingStats.droppedFrameCount);
+    }
+
+    void Context::pushFrameStats()
+    {
+#if OGUI_STATS
+        pendingStats.frameIndex = frameStats.frameIndex + 1;
+        frameStats = pendingStats;
+        pendingStats = FrameStats();
+
+        statsHistory[statsHistoryNext] = frameStats;
+        statsHistoryNext = (statsHistoryNext + 1) % FRAME_STATS_HISTORY_SIZE;
+        statsHistoryCount = std::min(statsHistoryCount + 1, FRAME_STATS_HISTORY_SIZE);
+#endif
+    }
+
+    uint32_t Context::getFrameStatsHistory(FrameStats *pStats, uint32_t maxCount) const
+    {
+        auto count = std::min(maxCount, statsHistoryCount);
+        auto first = (statsHistoryNext + FRAME_STATS_HISTORY_SIZE - count) % FRAME_STATS_HISTORY_SIZE; // Most recent ones
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            pStats[i] = statsHistory[(first + i) % FRAME_STATS_HISTORY_SIZE];
+        }
+        return count;
+    }
+
+    void Context::updateTextures()
+    {
+        pTextureManager->upload();
+    }
+
+    void Context::setTextureBudget(uint64_t bytes)
+    {
+        pTextureManager->setBudget(bytes);
+    }
+
+    uint64_t Context::getTextureMemory() const
+    {
+        return pTextureManager->getBytes();
+    }
+
     void Context::setTheme(const Theme &in_theme)
     {
-        theme = in_theme; // TODO: update textures
-        isDirty = true;
+        theme = in_theme;
+        ++themeVersion;
+        loadThemeImages();
+        updateLayout(); // Invalidates all cached geometry
     }
 
     void Context::setDirty()
+    {
+        setDirty(getRect());
+    }
+
+    void Context::setDirty(const Rect &rect)
     {
         isDirty = true;
+        if (rect.w <= 0.0f || rect.h <= 0.0f) return;
+
+        damageRects.push_back(rect);
+        if (damageRects.size() >= MAX_PENDING_DAMAGE_RECTS) mergeDamage();
+    }
+
+    void Context::postDirty()
+    {
+        pInvalidateQueue->postDirty();
+    }
+
+    void Context::postInvalidate(const IPanelRef &pPanel)
+    {
+        pInvalidateQueue->post(std::dynamic_pointer_cast<Panel>(pPanel));
+    }
+
+    void Context::postInvalidate(const WidgetRef &pWidget)
+    {
+        pInvalidateQueue->post(pWidget);
+    }
+
+    void Context::setWakeCallback(const std::function<void()> &callback)
+    {
+        pInvalidateQueue->setWakeCallback(callback);
+    }
+
+    void Context::handleInvalidations()
+    {
+        bool isDirtyPosted = false;
+        ArenaAllocator<void> allocator(pFrameArena);
+        ArenaVector<std::weak_ptr<Panel>> invalidatedPanels(allocator);
+        ArenaVector<std::weak_ptr<Widget>> invalidatedWidgets(allocator);
+        if (!pInvalidateQueue->take(isDirtyPosted, invalidatedPanels, invalidatedWidgets)) return;
+
+        OGUI_TRACE_ZONE("Context::handleInvalidations");
+        if (isDirtyPosted) setDirty();
+
+        // Targets removed or destroyed since they were posted are skipped
+        for (const auto &panel : invalidatedPanels)
+        {
+            auto pPanel = panel.lock();
+            if (pPanel && pPanel->pContext == this) pPanel->invalidateLayout();
+        }
+        for (const auto &widget : invalidatedWidgets)
+        {
+            if (auto pWidget = widget.lock()) pWidget->invalidate();
+        }
     }
 
     void Context::onResize(int in_width, int in_height)
+    {
+        queueInput(eInputType::Resize, in_width, in_height);
+    }
+
+    void Context::onMouseMove(int x, int y)
+    {
+        queueInput(eInputType::MouseMove, x, y);
+    }
+
+    void Context::onMouseButtonDown(int button)
+    {
+        queueInput(eInputType::MouseButtonDown, button);
+    }
+
+    void Context::onMouseButtonUp(int button)
+    {
+        queueInput(eInputType::MouseButtonUp, button);
+    }
+
+    void Context::onMouseScroll(int scroll)
+    {
+        queueInput(eInputType::MouseScroll, scroll);
+    }
+
+    void Context::onKeyDown(int key)
+    {
+        queueInput(eInputType::KeyDown, key);
+    }
+
+    void Context::onKeyUp(int key)
+    {
+        queueInput(eInputType::KeyUp, key);
+    }
+
+    void Context::onTextInput(const std::string &text)
+    {
+        if (text.empty()) return;
+        if (pInputQueue->isFull()) handleInput();
+        pInputQueue->pushText(text);
+    }
+
+    void Context::queueInput(eInputType type, int x, int y)
+    {
+        // Never grows past its capacity. The oldest events are handled now instead of at the next render().
+        if (pInputQueue->isFull()) handleInput();
+        pInputQueue->push(type, x, y);
+    }
+
+    void Context::handleInput()
+    {
+        if (pInputQueue->empty()) return;
+        OGUI_TRACE_ZONE("Context::handleInput");
+        OGUI_STAT_TIMER(pendingStats.inputTime);
+
+        auto now = std::chrono::steady_clock::now();
+        for (const auto &event : pInputQueue->getEvents())
+        {
+            OGUI_STAT(pendingStats.inputLatency = std::max(pendingStats.inputLatency, std::chrono::duration<float, std::milli>(now - event.time).count()));
+            switch (event.type)
+            {
+                case eInputType::Resize: handleResize(event.x, event.y); break;
+                case eInputType::MouseMove: handleMouseMove(event.x, event.y); break;
+                case eInputType::MouseButtonDown: handleMouseButtonDown(event.x); break;
+                case eInputType::MouseButtonUp: handleMouseButtonUp(event.x); break;
+                case eInputType::MouseScroll: handleMouseScroll(event.x); break;
+                case eInputType::KeyDown: handleKeyDown(event.x); break;
+                case eInputType::KeyUp: handleKeyUp(event.x); break;
+                case eInputType::TextInput: handleTextInput(std::string(pInputQueue->getText(event), event.textLength)); break;
+            }
+        }
+
+        OGUI_STAT(pendingStats.inputEventCount += pInputQueue->getReceivedCount());
+        OGUI_STAT(pendingStats.inputHandledCount += (uint32_t)pInputQueue->getEvents().size());
+        pInputQueue->clear();
+    }
+
+    void Context::handleResize(int in_width, int in_height)
     {
         bool shouldUpdateLayout = false;
         if (width != in_width || height != in_height)
@@ -247,75 +517,528 @@ namespace ogui
         }
     }
 
-    void Context::onMouseMove(int x, int y)
+    void Context::handleMouseMove(int x, int y)
     {
+        mouseX = x;
+        mouseY = y;
+
+        if (pPanelsManager->dragging_split != DOCK_NULL)
+        {
+            pPanelsManager->dragSplit((float)x, (float)y, this);
+            updateLayout();
+        }
+        updateHover();
     }
 
-    void Context::onMouseButtonDown(int button)
+    void Context::handleMouseButtonDown(int button)
     {
+        Vec2 position = { (float)mouseX, (float)mouseY };
+        auto pHit = pPanelsManager->hitTest(position.x, position.y);
+        if (!pHit) return;
+
+        switch (pHit->type)
+        {
+            case eHitType::Tab:
+                if (button == 0) pPanelsManager->activatePanel((const Panel*)pHit->data, this);
+                break;
+            case eHitType::Split:
+                if (button == 0) pPanelsManager->dragging_split = (uint32_t)pHit->data;
+                break;
+            case eHitType::Zone:
+                if (auto pPanel = pPanelsManager->activePanelAt(position.x, position.y))
+                {
+                    if (auto pWidget = pPanel->hitTest(position.x, position.y)) pWidget->onMouseButtonDown(this, button, position);
+                }
+                break;
+            default:
+                break;
+        }
     }
 
-    void Context::onMouseButtonUp(int button)
+    void Context::handleMouseButtonUp(int button)
     {
+        if (button == 0) pPanelsManager->dragging_split = DOCK_NULL;
     }
 
-    void Context::onMouseScroll(int scroll)
+    void Context::handleMouseScroll(int scroll)
     {
+        if (auto pPanel = pPanelsManager->activePanelAt((float)mouseX, (float)mouseY))
+        {
+            pPanel->setScrollOffset(pPanel->getScrollOffset() - (double)scroll * theme.listItemHeight * 3.0);
+        }
+        updateHover();
     }
 
-    void Context::onKeyDown(int key)
+    void Context::updateHover()
     {
+        Vec2 position = { (float)mouseX, (float)mouseY };
+        Widget *pWidget = nullptr;
+        if (pPanelsManager->dragging_split == DOCK_NULL)
+        {
+            auto pHit = pPanelsManager->hitTest(position.x, position.y);
+            if (pHit && pHit->type == eHitType::Zone)
+            {
+                if (auto pPanel = pPanelsManager->activePanelAt(position.x, position.y)) pWidget = pPanel->hitTest(position.x, position.y);
+            }
+        }
+
+        if (pWidget != pHoveredWidget && pHoveredWidget) unhover(pHoveredWidget);
+        pHoveredWidget = pWidget;
+        if (pWidget) pWidget->onMouseMove(this, position);
     }
 
-    void Context::onKeyUp(int key)
+    void Context::unhover(const Widget *pWidget)
     {
+        if (pWidget != pHoveredWidget) return;
+        auto pLeft = pHoveredWidget;
+        pHoveredWidget = nullptr;
+        pLeft->onMouseLeave(this);
     }
 
-    void Context::onTextInput(const std::string &text)
+    void Context::handleKeyDown(int /*key*/)
+    {
+    }
+
+    void Context::handleKeyUp(int /*key*/)
+    {
+    }
+
+    void Context::handleTextInput(const std::string & /*text*/)
     {
     }
 
     void Context::updateLayout()
     {
+        if (updateDepth)
+        {
+            isLayoutPending = true;
+            return;
+        }
+
+        OGUI_STAT_TIMER(pendingStats.layoutTime);
+        isLayoutPending = false;
         pPanelsManager->updateLayout(this);
-        isDirty = true;
+        setDirty();
     }
 
-    void Context::flush()
+    void Context::updateLayout(const Panel *pPanel)
     {
-        if (drawCmd.drawData.vertexCount)
+        if (updateDepth)
         {
-            drawList.push_back(drawCmd);
-            drawCmd.drawData.vertexStart += drawCmd.drawData.vertexCount;
-            drawCmd.drawData.vertexCount = 0;
+            isLayoutPending = true; // The whole layout will be updated anyway
+            return;
         }
+
+        OGUI_STAT_TIMER(pendingStats.layoutTime);
+        pPanelsManager->updateLayout(pPanel, this);
     }
 
-    void Context::bindTexture(const Texture &texture)
+    void Context::mergeDamage()
+    {
+        // Snap to pixels and clip to the screen
+        auto screenRect = getRect();
+        for (auto it = damageRects.begin(); it != damageRects.end();)
+        {
+            auto x1 = std::max(std::floor(it->x), screenRect.x);
+            auto y1 = std::max(std::floor(it->y), screenRect.y);
+            auto x2 = std::min(std::ceil(it->x + it->w), screenRect.x + screenRect.w);
+            auto y2 = std::min(std::ceil(it->y + it->h), screenRect.y + screenRect.h);
+            if (x2 <= x1 || y2 <= y1)
+            {
+                it = damageRects.erase(it);
+                continue;
+            }
+            *it = { x1, y1, x2 - x1, y2 - y1 };
+            ++it;
+        }
+
+        // Merge overlapping rects so nothing is drawn twice. Then, while we have too many, merge the pair that wastes the least area.
+        while (true)
+        {
+            size_t bestA = 0, bestB = 0;
+            float bestCost = std::numeric_limits<float>::max();
+            bool overlaps = false;
+            for (size_t a = 0; a < damageRects.size() && !overlaps; ++a)
+            {
+                for (size_t b = a + 1; b < damageRects.size(); ++b)
+                {
+                    if (RectIntersects(damageRects[a], damageRects[b]))
+                    {
+                        bestA = a;
+                        bestB = b;
+                        overlaps = true;
+                        break;
+                    }
+                    auto cost = RectArea(RectUnion(damageRects[a], damageRects[b])) - RectArea(damageRects[a]) - RectArea(damageRects[b]);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestA = a;
+                        bestB = b;
+                    }
+                }
+            }
+
+            if (!overlaps && damageRects.size() <= MAX_DAMAGE_RECTS) break;
+
+            damageRects[bestA] = RectUnion(damageRects[bestA], damageRects[bestB]);
+            damageRects.erase(damageRects.begin() + bestB);
+        }
+    }
+
+    bool Context::isDamaged(const Rect &rect) const
+    {
+        return RectIntersects(rect, currentDamage);
+    }
+
+    static bool Flush(DrawTarget &target)
+    {
+        auto &drawCmd = target.drawCmd;
+        if (!drawCmd.drawData.vertexCount) return false;
+
+        target.drawList.push_back(drawCmd);
+        drawCmd.drawData.vertexStart += drawCmd.drawData.vertexCount;
+        drawCmd.drawData.vertexCount = 0;
+        return true;
+    }
+
+    // Remembers the first bind of a zone, appendTarget() may drop it
+    static void PushBind(DrawTarget &target, const Texture *pTexture, bool isSplittingDraw)
     {
-        if (texture.id == lastBoundTexture) return;
-        flush();
+        if (!target.lastBoundTexture && !target.pCurrentCache && target.firstBindCommand == DrawTarget::NONE)
+        {
+            target.firstBindCommand = (uint32_t)target.drawList.size();
+            target.isFirstBindSplittingDraw = isSplittingDraw;
+        }
 
         DrawCommand cmd;
         cmd.command = eDrawCommand::BindTexture;
-        cmd.bindTextureData.textureId = texture.id;
-        drawList.push_back(cmd);
+        cmd.bindTextureData.pTexture = pTexture;
+        target.drawList.push_back(cmd);
+        target.lastBoundTexture = pTexture;
+    }
+
+    DrawTarget::DrawTarget()
+    {
+        drawCmd.command = eDrawCommand::Draw;
+        clear();
+    }
+
+    void DrawTarget::clear()
+    {
+        vertices.clear();
+        drawList.clear();
+        drawCmd.drawData.vertexStart = 0;
+        drawCmd.drawData.vertexCount = 0;
+        lastBoundTexture = nullptr;
+        pCurrentCache = nullptr;
+        firstBindCommand = NONE;
+        isFirstBindSplittingDraw = false;
+        isReadOnly = false;
+        isIncomplete = false;
+    }
+
+    void Context::setRenderThreads(uint32_t count)
+    {
+        auto workerCount = count > 1 ? count - 1 : 0;
+        if (pJobPool && pJobPool->getThreadCount() == workerCount + 1) return;
+
+        delete pJobPool;
+        pJobPool = workerCount ? new JobPool(workerCount) : nullptr;
+    }
+
+    void Context::setSubmitThread(bool enabled)
+    {
+        if (enabled == (pRenderThread != nullptr)) return;
+
+        if (enabled)
+        {
+            pRenderThread = new RenderThread(this);
+            return;
+        }
+
+        // Draws the last frame and runs the texture calls left before returning
+        delete pRenderThread;
+        pRenderThread = nullptr;
+    }
+
+    void Context::beginTarget(DrawTarget &target, bool isReadOnly)
+    {
+        target.clear();
+        target.isReadOnly = isReadOnly;
+        ThreadDrawTarget() = &target;
+    }
+
+    void Context::endTarget(DrawTarget &target)
+    {
+        Flush(target);
+        ThreadDrawTarget() = nullptr;
+    }
+
+    void Context::appendTarget(const DrawTarget &target)
+    {
+        // Same draw list as if the zone was generated straight into the frame
+        Flush(frameTarget);
+        auto vertexStart = (uint32_t)frameTarget.vertices.size();
+        frameTarget.vertices.insert(frameTarget.vertices.end(), target.vertices.begin(), target.vertices.end());
+
+        auto &drawList = frameTarget.drawList;
+        auto isJoiningDraws = false;
+        for (uint32_t i = 0, count = (uint32_t)target.drawList.size(); i < count; ++i)
+        {
+            auto cmd = target.drawList[i];
+            if (cmd.command == eDrawCommand::Draw)
+            {
+                // The draw before the dropped bind goes on
+                if (isJoiningDraws) drawList.back().drawData.vertexCount += cmd.drawData.vertexCount;
+                else
+                {
+                    cmd.drawData.vertexStart += vertexStart;
+                    drawList.push_back(cmd);
+                }
+                isJoiningDraws = false;
+                continue;
+            }
+
+            isJoiningDraws = false;
+            if (cmd.command == eDrawCommand::BindTexture)
+            {
+                if (i == target.firstBindCommand && cmd.bindTextureData.pTexture == frameTarget.lastBoundTexture)
+                {
+                    isJoiningDraws = target.isFirstBindSplittingDraw;
+                    continue;
+                }
+                frameTarget.lastBoundTexture = cmd.bindTextureData.pTexture;
+            }
+            drawList.push_back(cmd);
+        }
+
+        frameTarget.drawCmd.drawData.vertexStart = (uint32_t)frameTarget.vertices.size();
+    }
+
+    bool Context::canLoad()
+    {
+        auto &target = getTarget();
+        if (!target.isReadOnly) return true;
+
+        target.isIncomplete = true;
+        return false;
+    }
+
+    void Context::flush()
+    {
+        Flush(getTarget());
+    }
+
+    void Context::bindTexture(const Texture &texture)
+    {
+        auto &target = getTarget();
+        if (&texture == target.lastBoundTexture) return;
+
+        auto isSplittingDraw = Flush(target);
+        PushBind(target, &texture, isSplittingDraw);
+    }
+
+    void Context::updateIndices(uint32_t vertexCount)
+    {
+        // Index buffer is static, it only grows when we draw more quads than ever before
+        auto quadCount = vertexCount / 4;
+        auto oldQuadCount = (uint32_t)indices.size() / 6;
+        if (quadCount <= oldQuadCount) return;
+
+        auto newQuadCount = std::max(oldQuadCount * 2, (uint32_t)1024);
+        while (newQuadCount < quadCount) newQuadCount *= 2;
 
-        lastBoundTexture = texture.id;
+        indices.resize(newQuadCount * 6);
+        for (uint32_t i = oldQuadCount; i < newQuadCount; ++i)
+        {
+            auto pIndex = indices.data() + i * 6;
+            auto vertexStart = i * 4;
+            pIndex[0] = vertexStart + 0;
+            pIndex[1] = vertexStart + 1;
+            pIndex[2] = vertexStart + 2;
+            pIndex[3] = vertexStart + 2;
+            pIndex[4] = vertexStart + 3;
+            pIndex[5] = vertexStart + 0;
+        }
+
+        pRenderer->setIndexData(indices.data(), (uint32_t)indices.size());
+    }
+
+    void Context::scissor(const Rect &rect)
+    {
+        auto &target = getTarget();
+        Flush(target);
+
+        DrawCommand cmd;
+        cmd.command = eDrawCommand::SetScissor;
+        cmd.scissorData.x = (uint32_t)rect.x;
+        cmd.scissorData.y = (uint32_t)rect.y;
+        cmd.scissorData.width = (uint32_t)rect.w;
+        cmd.scissorData.height = (uint32_t)rect.h;
+        target.drawList.push_back(cmd);
+    }
+
+    void Context::drawQuad(const Rect &rect, const Rect &uv, uint32_t color32)
+    {
+        auto &target = getTarget();
+        auto &vertices = target.vertices;
+        if (caps.indexedDraw)
+        {
+            vertices.push_back(Vertex{ { rect.x, rect.y }, { uv.x, uv.y }, color32 });
+            vertices.push_back(Vertex{ { rect.x, rect.y + rect.h }, { uv.x, uv.y + uv.h }, color32 });
+            vertices.push_back(Vertex{ { rect.x + rect.w, rect.y + rect.h }, { uv.x + uv.w, uv.y + uv.h }, color32 });
+            vertices.push_back(Vertex{ { rect.x + rect.w, rect.y }, { uv.x + uv.w, uv.y }, color32 });
+
+            target.drawCmd.drawData.vertexCount += 4;
+            return;
+        }
+
+        vertices.push_back(Vertex{ { rect.x, rect.y }, { uv.x, uv.y }, color32 });
+        vertices.push_back(Vertex{ { rect.x, rect.y + rect.h }, { uv.x, uv.y + uv.h }, color32 });
+        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y + rect.h }, { uv.x + uv.w, uv.y + uv.h }, color32 });
+        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y + rect.h }, { uv.x + uv.w, uv.y + uv.h }, color32 });
+        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y }, { uv.x + uv.w, uv.y }, color32 });
+        vertices.push_back(Vertex{ { rect.x, rect.y }, { uv.x, uv.y }, color32 });
+
+        target.drawCmd.drawData.vertexCount += 6;
     }
 
     void Context::drawRect(const Rect &rect, const Color &color)
+    {
+        bindTexture(*pAtlas->white.pTexture);
+        drawQuad(rect, pAtlas->white.uv, ColorToHex(color));
+    }
+
+    void Context::drawImage(const Rect &rect, const AtlasRegion &region, const Color &color)
+    {
+        bindTexture(*region.pTexture);
+        drawQuad(rect, region.uv, ColorToHex(color));
+    }
+
+    void Context::drawText(Font &font, const std::string &text, const Vec2 &position, const Color &color)
     {
         auto color32 = ColorToHex(color);
+        auto penX = position.x;
+        auto penY = (float)(int)position.y;
+        uint32_t previous = 0;
+
+        // Glyphs share atlas pages, so consecutive glyphs batch in the same draw
+        const char *pText = text.c_str();
+        const char *pEnd = pText + text.size();
+        while (pText < pEnd)
+        {
+            auto codepoint = Font::decodeUtf8(pText, pEnd);
+            if (previous) penX += font.getKerning(previous, codepoint);
+            previous = codepoint;
+
+            const auto &glyph = font.getGlyph(codepoint);
+            if (glyph.region.pTexture)
+            {
+                bindTexture(*glyph.region.pTexture);
+                drawQuad({
+                    (float)(int)penX + (float)glyph.metrics.offsetX,
+                    penY + (float)glyph.metrics.offsetY,
+                    (float)glyph.metrics.width,
+                    (float)glyph.metrics.height }, glyph.region.uv, color32);
+            }
+            penX += glyph.metrics.advance;
+        }
+    }
+
+    Font *Context::getFont(const std::string &name, float size)
+    {
+        for (auto pFont : fonts)
+        {
+            if (pFont->size == size && pFont->name == name) return pFont;
+        }
+        if (!canLoad()) return pPlaceholderFont;
+
+        auto pFont = new Font(this, name, size);
+        fonts.push_back(pFont);
+        return pFont;
+    }
+
+    void Context::loadThemeImages()
+    {
+        // Load them now so they are uploaded before the draw list needs them
+        for (const auto *pFilename : {
+            &theme.newIcon, &theme.openIcon, &theme.saveIcon, &theme.undoIcon, &theme.redoIcon,
+            &theme.selectIcon, &theme.moveIcon, &theme.rotateIcon, &theme.scaleIcon,
+            &theme.scrollbar, &theme.xIcon })
+        {
+            pAtlas->getImage(*pFilename);
+        }
+    }
+
+    void Context::beginCache(DrawCache &cache)
+    {
+        auto &target = getTarget();
+        assert(!target.pCurrentCache && "Caches cannot be nested.");
+        Flush(target);
 
-        vertices.push_back(Vertex{ { rect.x, rect.y }, { 0, 0 }, color32 });
-        vertices.push_back(Vertex{ { rect.x, rect.y + rect.h }, { 0, 0 }, color32 });
-        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y + rect.h }, { 0, 0 }, color32 });
-        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y + rect.h }, { 0, 0 }, color32 });
-        vertices.push_back(Vertex{ { rect.x + rect.w, rect.y }, { 0, 0 }, color32 });
-        vertices.push_back(Vertex{ { rect.x, rect.y }, { 0, 0 }, color32 });
+        // Swap our buffers with the cache's, so draw calls write directly into it. It starts with nothing bound.
+        target.pCurrentCache = &cache;
+        target.cacheVertexStart = target.drawCmd.drawData.vertexStart;
+        target.cacheLastBoundTexture = target.lastBoundTexture;
+        std::swap(target.vertices, cache.vertices);
+        std::swap(target.drawList, cache.drawList);
+        target.vertices.clear();
+        target.drawList.clear();
+        target.drawCmd.drawData.vertexStart = 0;
+        target.lastBoundTexture = nullptr;
+    }
+
+    void Context::endCache(DrawCache &cache)
+    {
+        auto &target = getTarget();
+        assert(target.pCurrentCache == &cache && "Mismatched beginCache/endCache.");
+        Flush(target);
+
+        std::swap(target.vertices, cache.vertices);
+        std::swap(target.drawList, cache.drawList);
+        target.drawCmd.drawData.vertexStart = target.cacheVertexStart;
+
+        // Textures must live as long as the cache can be drawn
+        cache.textures.clear();
+        for (const auto &cmd : cache.drawList)
+        {
+            if (cmd.command == eDrawCommand::BindTexture) cache.textures.push_back(cmd.bindTextureData.pTexture->shared_from_this());
+        }
+        target.lastBoundTexture = target.cacheLastBoundTexture;
+        target.pCurrentCache = nullptr;
+    }
+
+    void Context::drawCache(const DrawCache &cache)
+    {
+        if (cache.drawList.empty()) return;
+        auto &target = getTarget();
+        Flush(target);
+
+        auto &vertices = target.vertices;
+        auto vertexStart = (uint32_t)vertices.size();
+        vertices.resize(vertexStart + cache.vertices.size());
+        memcpy(vertices.data() + vertexStart, cache.vertices.data(), sizeof(Vertex) * cache.vertices.size());
+
+        for (auto cmd : cache.drawList)
+        {
+            if (cmd.command == eDrawCommand::Draw)
+            {
+                cmd.drawData.vertexStart += vertexStart;
+                target.drawList.push_back(cmd);
+            }
+            else if (cmd.command == eDrawCommand::BindTexture)
+            {
+                // The cache's first bind may already be done
+                if (cmd.bindTextureData.pTexture != target.lastBoundTexture) PushBind(target, cmd.bindTextureData.pTexture, false);
+            }
+            else
+            {
+                target.drawList.push_back(cmd);
+            }
+        }
 
-        drawCmd.drawData.vertexCount += 6;
+        target.drawCmd.drawData.vertexStart = (uint32_t)vertices.size();
     }
 
     IContext *IContext::create(IRenderer *pRenderer, int width, int height)
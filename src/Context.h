@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ogui/IContext.h"
+#include "InputQueue.h"
+#include "InvalidateQueue.h"
+#include "TextureManager.h"
 #include <vector>
 
 namespace ogui
@@ -15,33 +18,100 @@ namespace ogui
 
     struct DrawCommand
     {
+        // Declared outside of the union, anonymous unions can only hold data members in standard C++
+        struct DrawData
+        {
+            uint32_t vertexStart, vertexCount;
+        };
+
+        struct ScissorData
+        {
+            uint32_t x, y, width, height;
+        };
+
+        struct BindTextureData
+        {
+            const Texture *pTexture; // Resolved to its id on submission, so textures created while generating can be bound
+        };
+
+        struct UserDrawData
+        {
+            UserDrawFn userDrawFn;
+            void *pUserData;
+            uint32_t x, y, width, height;
+        };
+
         eDrawCommand command;
         union
         {
-            struct DrawData
-            {
-                uint32_t vertexStart, vertexCount;
-            } drawData;
-
-            struct ScissorData
-            {
-                uint32_t x, y, width, height;
-            } scissorData;
-
-            struct BindTextureData
-            {
-                uintptr_t textureId;
-            } bindTextureData;
-
-            struct UserDrawData
-            {
-                UserDrawFn userDrawFn;
-                void *pUserData;
-                uint32_t x, y, width, height;
-            } userDrawData;
+            DrawData drawData;
+            ScissorData scissorData;
+            BindTextureData bindTextureData;
+            UserDrawData userDrawData;
         };
     };
 
+    // Retained geometry of a part of the screen. Regenerated only when its owner's version changes.
+    struct DrawCache
+    {
+        std::vector<Vertex> vertices;
+        std::vector<DrawCommand> drawList; // Starts with nothing bound, so it draws the same wherever it was generated
+        std::vector<std::shared_ptr<const Texture>> textures; // Keeps every texture the draw commands bind alive
+        uint64_t version = ~0ull;
+    };
+
+    // Where draw calls go. The Context draws into its frame target, except on threads generating a dock zone, which
+    // draw into the zone's own target. Zone targets are appended to the frame in dock order.
+    struct DrawTarget
+    {
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        DrawTarget();
+        void clear(); // Keeps the memory
+
+        std::vector<Vertex> vertices;
+        std::vector<DrawCommand> drawList;
+        DrawCommand drawCmd; // Draw being batched
+        const Texture *lastBoundTexture = nullptr;
+
+        // Cache being generated, and what to restore after it
+        DrawCache *pCurrentCache = nullptr;
+        uint32_t cacheVertexStart = 0;
+        const Texture *cacheLastBoundTexture = nullptr;
+
+        // A zone starts with nothing bound. When appended, its first bind is dropped if the texture is already bound.
+        uint32_t firstBindCommand = NONE;
+        bool isFirstBindSplittingDraw = false; // The bind ended a draw, which goes on after it when the bind is dropped
+
+        bool isReadOnly = false;    // Fonts and the atlas are shared with other threads, they must not change
+        bool isIncomplete = false;  // Read only, and needed something not loaded yet
+    };
+
+    // Packs a color to 0xRRGGBBAA. Components are clamped to [0, 1], NaN packs to 0.
+    inline uint32_t ColorToHex(const Color &col)
+    {
+        auto toByte = [](float value) -> uint32_t
+        {
+            value *= 255.f;
+            return value > 0.f ? (uint32_t)(value < 255.f ? value : 255.f) : 0;
+        };
+        return (toByte(col.r) << 24) | (toByte(col.g) << 16) | (toByte(col.b) << 8) | toByte(col.a);
+    }
+
+    // Target of the calling thread while it generates a zone
+    inline DrawTarget *&ThreadDrawTarget()
+    {
+        static thread_local DrawTarget *pTarget = nullptr;
+        return pTarget;
+    }
+
+    class Atlas;
+    class FrameArena;
+    class JobPool;
+    class RenderThread;
+    struct AtlasRegion;
+    class Font;
+
     class PanelsManager;
 
     class Panel;
@@ -50,18 +120,13 @@ namespace ogui
     class Context final : public IContext
     {
     public:
-        struct Texture
-        {
-            uint8_t *pData;
-            uint32_t width, height;
-            uintptr_t id;
-        };
-
         Context(IRenderer *pRenderer, int width, int height);
         ~Context();
 
         void add(const IPanelRef &pPanel, const IPanelRef &pDockParent, eDockPosition dockPosition) override;
         void remove(const IPanelRef &pPanel) override;
+        void beginUpdate() override;
+        void endUpdate() override;
 
         void render() override;
 
@@ -69,6 +134,19 @@ namespace ogui
         void setTheme(const Theme &theme) override;
 
         void setDirty() override;
+        void setDirty(const Rect &rect) override;
+        void postDirty() override;
+        void postInvalidate(const IPanelRef &pPanel) override;
+        void postInvalidate(const WidgetRef &pWidget) override;
+        void setWakeCallback(const std::function<void()> &callback) override;
+
+        void setTextureBudget(uint64_t bytes) override;
+        void setRenderThreads(uint32_t count) override;
+        void setSubmitThread(bool enabled) override;
+        uint64_t getTextureMemory() const override;
+
+        const FrameStats &getFrameStats() const override { return frameStats; }
+        uint32_t getFrameStatsHistory(FrameStats *pStats, uint32_t maxCount) const override;
 
         void onResize(int width, int height) override;
         void onMouseMove(int x, int y) override;
@@ -79,34 +157,91 @@ namespace ogui
         void onKeyUp(int key) override;
         void onTextInput(const std::string &text) override;
 
-        void updateLayout();
+        // The on*() events are queued, and handled by these at the next render()
+        void queueInput(eInputType type, int x = 0, int y = 0);
+        void handleInput();
+        void handleResize(int width, int height);
+        void handleMouseMove(int x, int y);
+        void handleMouseButtonDown(int button);
+        void handleMouseButtonUp(int button);
+        void handleMouseScroll(int scroll);
+        void handleKeyDown(int key);
+        void handleKeyUp(int key);
+        void handleTextInput(const std::string &text);
+        void handleInvalidations(); // Posted from other threads
+        void updateHover(); // After the mouse moved, or what is under it did
+        void unhover(const Widget *pWidget); // The widget leaves its panel
+
+        bool renderFrame(); // False when nothing was submitted
+        void submit(const std::vector<Vertex> &vertices, const std::vector<DrawCommand> &drawList, const std::vector<Rect> &damage, FrameStats &stats, bool isTouchingTextures);
+        void publishFrame(); // To the render thread
+        void pushFrameStats();
+        void updateLayout(); // Deferred to endUpdate() during a batch
+        void updateLayout(const Panel *pPanel); // Only the zone holding the panel
+        void updateTextures();
+        void mergeDamage();
+        bool isDamaged(const Rect &rect) const;
+
+        DrawTarget &getTarget() { auto pTarget = ThreadDrawTarget(); return pTarget ? *pTarget : frameTarget; }
+        void beginTarget(DrawTarget &target, bool isReadOnly); // Draw calls of this thread go to target, until endTarget()
+        void endTarget(DrawTarget &target);
+        void appendTarget(const DrawTarget &target); // To the frame
+        bool isReadOnly() { return getTarget().isReadOnly; }
+        bool canLoad(); // False when read only, the target is then marked incomplete. Call before adding to a font or the atlas.
 
         void flush();
         void bindTexture(const Texture &texture);
+        void scissor(const Rect &rect);
+        void drawQuad(const Rect &rect, const Rect &uv, uint32_t color32);
         void drawRect(const Rect &rect, const Color &color);
+        void drawRects(const Rect *pRects, const Color *pColors, uint32_t count);
+        void drawRects(const Rect *pRects, const uint32_t *pColors32, uint32_t count); // Colors already packed as 0xRRGGBBAA
+        void drawImage(const Rect &rect, const AtlasRegion &region, const Color &color);
+        void drawText(Font &font, const std::string &text, const Vec2 &position, const Color &color);
+        Font *getFont(const std::string &name, float size);
+        void loadThemeImages();
+        void beginCache(DrawCache &cache);
+        void endCache(DrawCache &cache);
+        void drawCache(const DrawCache &cache);
+        void updateIndices(uint32_t vertexCount); // Of the frame being submitted
 
         Rect getRect() const { return { 0.0f, 0.0f, (float)width, (float)height }; }
 
     public:
         IRenderer *pRenderer = nullptr;
+        RendererCaps caps;
         bool isDirty = true;
         
         int width = 200, height = 200;
         int mouseX = 0, mouseY = 0;
+        Widget *pHoveredWidget = nullptr; // Under the mouse, in a docked panel
 
-        std::vector<Vertex> vertices;
-        std::vector<DrawCommand> drawList;
-        std::vector<Texture *> textureToCreate;
-        std::vector<Texture *> textureToUpdate;
-        std::vector<Texture *> textureToDestroy;
+        DrawTarget frameTarget;
+        std::vector<CompactVertex> compactVertices;
+        std::vector<uint32_t> indices;
+        std::vector<Rect> damageRects;
+        Rect currentDamage = { 0.0f, 0.0f, 0.0f, 0.0f };
         Theme theme;
-
-        Texture whiteTexture;
-
-        DrawCommand drawCmd;
-        uintptr_t lastBoundTexture = 0;
-
-        PanelsManager *pPanelsManager = nullptr;
-        std::vector<PanelRef> panels;
+        uint32_t themeVersion = 0; // Widgets measured with another theme are measured again
+
+        FrameArena *pFrameArena = nullptr; // Scratch memory, reset at the start of every render()
+        InputQueue *pInputQueue = nullptr;
+        InvalidateQueue *pInvalidateQueue = nullptr;
+        TextureManager *pTextureManager = nullptr;
+        Atlas *pAtlas = nullptr;
+        std::vector<Font *> fonts;
+        Font *pPlaceholderFont = nullptr; // Returned by getFont() for fonts not loaded yet, when read only
+        JobPool *pJobPool = nullptr; // Generates the dock zones, when there is more than one render thread
+        RenderThread *pRenderThread = nullptr; // Submits the frames, when not submitted by render()
+
+        FrameStats pendingStats; // Accumulates until the next frame is submitted
+        FrameStats frameStats;
+        FrameStats statsHistory[FRAME_STATS_HISTORY_SIZE];
+        uint32_t statsHistoryNext = 0;
+        uint32_t statsHistoryCount = 0;
+
+        PanelsManager *pPanelsManager = nullptr; // Owns the docked panels
+        uint32_t updateDepth = 0; // Nested beginUpdate() calls
+        bool isLayoutPending = false;
     };
 }
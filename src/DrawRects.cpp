@@ -0,0 +1,158 @@
+#include "Atlas.h"
+#include "Context.h"
+#include "Simd.h"
+
+#include <algorithm>
+
+namespace ogui
+{
+    static const uint32_t COLOR_BATCH_SIZE = 256;
+
+    // Converts float colors to 0xRRGGBBAA, clamped the same as ColorToHex
+    static void PackColors(const Color *pColors, uint32_t *pOut, uint32_t count)
+    {
+        uint32_t i = 0;
+#if defined(OGUI_SSE2)
+        const auto scale = _mm_set1_ps(255.0f);
+        const auto zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i c[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                auto rgba = _mm_loadu_ps(&pColors[i + j].r);
+                rgba = _mm_min_ps(_mm_max_ps(_mm_mul_ps(rgba, scale), zero), scale);
+                auto abgr = _mm_shuffle_ps(rgba, rgba, _MM_SHUFFLE(0, 1, 2, 3)); // Little endian, so R ends up in the high byte
+                c[j] = _mm_cvttps_epi32(abgr);
+            }
+            auto c01 = _mm_packs_epi32(c[0], c[1]);
+            auto c23 = _mm_packs_epi32(c[2], c[3]);
+            _mm_storeu_si128((__m128i *)(pOut + i), _mm_packus_epi16(c01, c23));
+        }
+#elif defined(OGUI_NEON)
+        const auto scale = vdupq_n_f32(255.0f);
+        const auto zero = vdupq_n_f32(0.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            auto rgba = vld4q_f32(&pColors[i].r); // De-interleaved: val[0] = 4 reds, val[1] = 4 greens, ...
+            uint32x4_t c[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                c[j] = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vmulq_f32(rgba.val[j], scale), zero), scale));
+            }
+            auto packed = vorrq_u32(vorrq_u32(vshlq_n_u32(c[0], 24), vshlq_n_u32(c[1], 16)), vorrq_u32(vshlq_n_u32(c[2], 8), c[3]));
+            vst1q_u32(pOut + i, packed);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            pOut[i] = ColorToHex(pColors[i]);
+        }
+    }
+
+    // Writes 4 (indexed) or 6 vertices per rect, all sampling the same uv.
+    static void WriteRects(const Rect *pRects, const uint32_t *pColors, const Vec2 &uv, Vertex *pOut, uint32_t count, bool indexed)
+    {
+#if defined(OGUI_SSE2) || defined(OGUI_NEON)
+#if defined(OGUI_SSE2)
+        const auto uvs = _mm_setr_ps(uv.x, uv.y, uv.x, uv.y);
+#else
+        const auto uvs = vcombine_f32(vld1_f32(&uv.x), vld1_f32(&uv.x));
+#endif
+        for (uint32_t i = 0; i < count; ++i)
+        {
+#if defined(OGUI_SSE2)
+            auto xywh = _mm_loadu_ps(&pRects[i].x);
+            auto xyxy = _mm_movelh_ps(xywh, xywh);
+            auto size = _mm_movehl_ps(xywh, _mm_setzero_ps()); // 0, 0, w, h
+            auto corners = _mm_add_ps(xyxy, size); // x, y, x + w, y + h
+            auto tl = _mm_movelh_ps(corners, uvs);
+            auto bl = _mm_movelh_ps(_mm_shuffle_ps(corners, corners, _MM_SHUFFLE(3, 0, 3, 0)), uvs);
+            auto br = _mm_movelh_ps(_mm_movehl_ps(corners, corners), uvs);
+            auto tr = _mm_movelh_ps(_mm_shuffle_ps(corners, corners, _MM_SHUFFLE(1, 2, 1, 2)), uvs);
+#define OGUI_STORE_VERTEX(pVertex, v) _mm_storeu_ps(&(pVertex)->position.x, v)
+#else
+            auto xywh = vld1q_f32(&pRects[i].x);
+            auto xy = vget_low_f32(xywh);
+            auto xy2 = vadd_f32(xy, vget_high_f32(xywh));
+            auto uvLow = vget_low_f32(uvs);
+            auto tl = vcombine_f32(xy, uvLow);
+            auto bl = vcombine_f32(vset_lane_f32(vget_lane_f32(xy2, 1), xy, 1), uvLow);
+            auto br = vcombine_f32(xy2, uvLow);
+            auto tr = vcombine_f32(vset_lane_f32(vget_lane_f32(xy, 1), xy2, 1), uvLow);
+#define OGUI_STORE_VERTEX(pVertex, v) vst1q_f32(&(pVertex)->position.x, v)
+#endif
+            auto color32 = pColors[i];
+            if (indexed)
+            {
+                OGUI_STORE_VERTEX(pOut + 0, tl); pOut[0].color = color32;
+                OGUI_STORE_VERTEX(pOut + 1, bl); pOut[1].color = color32;
+                OGUI_STORE_VERTEX(pOut + 2, br); pOut[2].color = color32;
+                OGUI_STORE_VERTEX(pOut + 3, tr); pOut[3].color = color32;
+                pOut += 4;
+            }
+            else
+            {
+                OGUI_STORE_VERTEX(pOut + 0, tl); pOut[0].color = color32;
+                OGUI_STORE_VERTEX(pOut + 1, bl); pOut[1].color = color32;
+                OGUI_STORE_VERTEX(pOut + 2, br); pOut[2].color = color32;
+                OGUI_STORE_VERTEX(pOut + 3, br); pOut[3].color = color32;
+                OGUI_STORE_VERTEX(pOut + 4, tr); pOut[4].color = color32;
+                OGUI_STORE_VERTEX(pOut + 5, tl); pOut[5].color = color32;
+                pOut += 6;
+            }
+#undef OGUI_STORE_VERTEX
+        }
+#else
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const auto &rect = pRects[i];
+            auto color32 = pColors[i];
+            Vertex tl = { { rect.x, rect.y }, uv, color32 };
+            Vertex bl = { { rect.x, rect.y + rect.h }, uv, color32 };
+            Vertex br = { { rect.x + rect.w, rect.y + rect.h }, uv, color32 };
+            Vertex tr = { { rect.x + rect.w, rect.y }, uv, color32 };
+            if (indexed)
+            {
+                pOut[0] = tl; pOut[1] = bl; pOut[2] = br; pOut[3] = tr;
+                pOut += 4;
+            }
+            else
+            {
+                pOut[0] = tl; pOut[1] = bl; pOut[2] = br; pOut[3] = br; pOut[4] = tr; pOut[5] = tl;
+                pOut += 6;
+            }
+        }
+#endif
+    }
+
+    void Context::drawRects(const Rect *pRects, const Color *pColors, uint32_t count)
+    {
+        // Pack in small batches to stay on the stack
+        uint32_t colors32[COLOR_BATCH_SIZE];
+        for (uint32_t i = 0; i < count; i += COLOR_BATCH_SIZE)
+        {
+            auto batchCount = std::min(count - i, COLOR_BATCH_SIZE);
+            PackColors(pColors + i, colors32, batchCount);
+            drawRects(pRects + i, colors32, batchCount);
+        }
+    }
+
+    void Context::drawRects(const Rect *pRects, const uint32_t *pColors32, uint32_t count)
+    {
+        if (!count) return;
+
+        bindTexture(*pAtlas->white.pTexture);
+
+        auto &target = getTarget();
+        auto &vertices = target.vertices;
+        auto verticesPerQuad = caps.indexedDraw ? 4u : 6u;
+        auto vertexStart = vertices.size();
+        vertices.resize(vertexStart + count * verticesPerQuad);
+
+        Vec2 uv = { pAtlas->white.uv.x, pAtlas->white.uv.y };
+        WriteRects(pRects, pColors32, uv, vertices.data() + vertexStart, count, caps.indexedDraw);
+
+        target.drawCmd.drawData.vertexCount += count * verticesPerQuad;
+    }
+}
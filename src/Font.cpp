@@ -0,0 +1,222 @@
+#include "Font.h"
+#include "Context.h"
+#include "ogui/IRenderer.h"
+
+#include <cstring>
+
+namespace ogui
+{
+    static const uint32_t CACHE_WAYS = 4;
+    static const uint32_t MIN_KERNING_ENTRIES = 256;
+    static const uint32_t MAX_KERNING_ENTRIES = 16384; // 256 KB
+    static const uint32_t MIN_MEASURE_ENTRIES = 1024;
+    static const uint32_t MAX_MEASURE_ENTRIES = 16384; // 1 MB
+
+    // FNV-1a
+    static uint64_t HashText(const std::string &text)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (auto c : text)
+        {
+            hash ^= (uint8_t)c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint32_t CacheSet(uint64_t hash, size_t entryCount)
+    {
+        return (uint32_t)((hash ^ (hash >> 32)) & (entryCount / CACHE_WAYS - 1)) * CACHE_WAYS;
+    }
+
+    // Doubles the table when a table's worth of entries was replaced since it last grew
+    template<typename Entry>
+    static void GrowCache(std::vector<Entry> &entries, uint32_t &replaced, uint32_t minEntries, uint32_t maxEntries)
+    {
+        if (!entries.empty() && (replaced < entries.size() || entries.size() >= maxEntries)) return;
+
+        std::vector<Entry> previous;
+        previous.swap(entries);
+        entries.resize(previous.empty() ? minEntries : previous.size() * 2);
+        replaced = 0;
+
+        // Sets only split, the entries of one go to two sets of the new table, with room for all of them
+        for (const auto &entry : previous)
+        {
+            if (!entry.lastUse) continue;
+            auto pSet = entries.data() + CacheSet(entry.hash, entries.size());
+            for (uint32_t i = 0; i < CACHE_WAYS; ++i)
+            {
+                if (pSet[i].lastUse) continue;
+                pSet[i] = entry;
+                break;
+            }
+        }
+    }
+
+    // An empty entry of the hash's set, or else its least recently used one
+    template<typename Entry>
+    static Entry &ReplaceCacheEntry(std::vector<Entry> &entries, uint32_t &replaced, uint64_t hash)
+    {
+        auto pSet = entries.data() + CacheSet(hash, entries.size());
+        auto pEntry = pSet;
+        for (uint32_t i = 1; i < CACHE_WAYS && pEntry->lastUse; ++i)
+        {
+            if (pSet[i].lastUse < pEntry->lastUse) pEntry = pSet + i;
+        }
+        if (pEntry->lastUse) ++replaced;
+        return *pEntry;
+    }
+
+    Font::Font(Context *in_pContext, const std::string &in_name, float in_size)
+        : name(in_name)
+        , size(in_size)
+        , pContext(in_pContext)
+    {
+    }
+
+    const Font::Glyph &Font::getGlyph(uint32_t codepoint)
+    {
+        static const Glyph MISSING_GLYPH = {};
+
+        auto it = glyphs.find(codepoint);
+        if (it != glyphs.end()) return it->second;
+        if (!pContext->canLoad()) return MISSING_GLYPH;
+
+        Glyph glyph;
+        glyphPixels.clear();
+        if (pContext->pRenderer->rasterizeGlyph(name, size, codepoint, glyph.metrics, glyphPixels))
+        {
+            if (glyph.metrics.width && glyph.metrics.height && glyphPixels.size() >= glyph.metrics.width * glyph.metrics.height * 4)
+            {
+                pContext->pAtlas->add(glyph.metrics.width, glyph.metrics.height, glyphPixels.data(), &glyph.region);
+            }
+        }
+        else
+        {
+            // Renderer can't do text. Keep layout sane with a fixed advance.
+            glyph.metrics = GlyphMetrics();
+            glyph.metrics.advance = (float)(int)(size * 0.5f);
+        }
+
+        return glyphs.insert({ codepoint, glyph }).first->second;
+    }
+
+    void Font::evict(const Texture *pTexture)
+    {
+        for (auto it = glyphs.begin(); it != glyphs.end();)
+        {
+            if (it->second.region.pTexture == pTexture) it = glyphs.erase(it);
+            else ++it;
+        }
+    }
+
+    bool Font::references(const Texture *pTexture) const
+    {
+        for (const auto &glyph : glyphs)
+        {
+            if (glyph.second.region.pTexture == pTexture) return true;
+        }
+        return false;
+    }
+
+    float Font::getKerning(uint32_t left, uint32_t right)
+    {
+        // An odd multiplier mixes the bits and keeps pairs apart
+        auto hash = (((uint64_t)left << 32) | (uint64_t)right) * 0x9E3779B97F4A7C15ull;
+        if (!kernings.empty())
+        {
+            auto pSet = kernings.data() + CacheSet(hash, kernings.size());
+            for (uint32_t i = 0; i < CACHE_WAYS; ++i)
+            {
+                auto &entry = pSet[i];
+                if (entry.lastUse && entry.hash == hash)
+                {
+                    if (!pContext->isReadOnly()) entry.lastUse = nextCacheUse();
+                    return entry.kerning;
+                }
+            }
+        }
+        if (!pContext->canLoad()) return 0.0f;
+
+        auto kerning = pContext->pRenderer->getKerning(name, size, left, right);
+
+        GrowCache(kernings, kerningReplaced, MIN_KERNING_ENTRIES, MAX_KERNING_ENTRIES);
+        auto &entry = ReplaceCacheEntry(kernings, kerningReplaced, hash);
+        entry.hash = hash;
+        entry.lastUse = nextCacheUse();
+        entry.kerning = kerning;
+
+        return kerning;
+    }
+
+    float Font::measure(const std::string &text)
+    {
+        auto isCacheable = text.size() <= MAX_MEASURED_TEXT;
+        auto hash = isCacheable ? HashText(text) : 0;
+        if (isCacheable && !measures.empty())
+        {
+            auto pSet = measures.data() + CacheSet(hash, measures.size());
+            for (uint32_t i = 0; i < CACHE_WAYS; ++i)
+            {
+                auto &entry = pSet[i];
+                if (entry.lastUse && entry.hash == hash && entry.length == text.size() && !memcmp(entry.text, text.data(), text.size()))
+                {
+                    if (!pContext->isReadOnly()) entry.lastUse = nextCacheUse();
+                    return entry.width;
+                }
+            }
+        }
+        if (!pContext->canLoad()) return 0.0f;
+
+        float width = 0.0f;
+        uint32_t previous = 0;
+        const char *pText = text.c_str();
+        const char *pEnd = pText + text.size();
+        while (pText < pEnd)
+        {
+            auto codepoint = decodeUtf8(pText, pEnd);
+            if (previous) width += getKerning(previous, codepoint);
+            width += getGlyph(codepoint).metrics.advance;
+            previous = codepoint;
+        }
+        if (!isCacheable) return width;
+
+        GrowCache(measures, measureReplaced, MIN_MEASURE_ENTRIES, MAX_MEASURE_ENTRIES);
+        auto &entry = ReplaceCacheEntry(measures, measureReplaced, hash);
+        entry.hash = hash;
+        entry.lastUse = nextCacheUse();
+        entry.width = width;
+        entry.length = (uint8_t)text.size();
+        memcpy(entry.text, text.data(), text.size());
+
+        return width;
+    }
+
+    uint32_t Font::nextCacheUse()
+    {
+        if (!++cacheClock) cacheClock = 1; // 0 is empty
+        return cacheClock;
+    }
+
+    uint32_t Font::decodeUtf8(const char *&pText, const char *pEnd)
+    {
+        auto c = (uint8_t)*pText++;
+        if (c < 0x80) return c;
+
+        int extraBytes;
+        uint32_t codepoint;
+        if ((c & 0xE0) == 0xC0) { extraBytes = 1; codepoint = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { extraBytes = 2; codepoint = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { extraBytes = 3; codepoint = c & 0x07; }
+        else return 0xFFFD; // Invalid lead byte
+
+        for (int i = 0; i < extraBytes; ++i)
+        {
+            if (pText >= pEnd || ((uint8_t)*pText & 0xC0) != 0x80) return 0xFFFD;
+            codepoint = (codepoint << 6) | ((uint8_t)*pText++ & 0x3F);
+        }
+
+        return codepoint;
+    }
+}
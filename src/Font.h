@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Atlas.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ogui
+{
+    class Context;
+
+    // A font at a given size. Glyphs are rasterized lazily by the renderer into the atlas.
+    // Advances, kerning and string widths are cached, so steady state layout doesn't rasterize or shape anything.
+    // While the context is read only, nothing is added to the caches and misses return empty values.
+    class Font final
+    {
+    public:
+        struct Glyph
+        {
+            GlyphMetrics metrics;
+            AtlasRegion region; // region.pTexture is null when there is nothing to draw
+        };
+
+        Font(Context *pContext, const std::string &name, float size);
+
+        const Glyph &getGlyph(uint32_t codepoint);
+        float getKerning(uint32_t left, uint32_t right);
+        float measure(const std::string &text);
+        void evict(const Texture *pTexture); // Forgets the glyphs rasterized into this texture
+        bool references(const Texture *pTexture) const; // Any glyph rasterized into this texture
+
+        static uint32_t decodeUtf8(const char *&pText, const char *pEnd);
+
+        std::string name;
+        float size = 14.0f;
+
+    private:
+        static const uint32_t MAX_MEASURED_TEXT = 47; // Longer strings are measured every time
+
+        // A cache line. The text is compared on a hit, hashes can collide.
+        struct MeasureEntry
+        {
+            uint64_t hash = 0; // Of the string's bytes
+            uint32_t lastUse = 0; // 0 when empty
+            float width = 0.0f;
+            uint8_t length = 0;
+            char text[MAX_MEASURED_TEXT];
+        };
+
+        struct KerningEntry
+        {
+            uint64_t hash = 0; // Of the codepoint pair, one to one so it is compared alone
+            uint32_t lastUse = 0; // 0 when empty
+            float kerning = 0.0f;
+        };
+
+        uint32_t nextCacheUse();
+
+        Context *pContext = nullptr;
+        std::unordered_map<uint32_t, Glyph> glyphs;
+        std::vector<uint8_t> glyphPixels; // Rasterization scratch, reused so new glyphs don't allocate
+
+        // Kerning pairs and string widths, found by hash so lookups don't allocate. Set associative, a full set replaces its least
+        // recently used entry. When a table's worth of entries was replaced, it doubles, up to a fixed maximum.
+        std::vector<KerningEntry> kernings;
+        std::vector<MeasureEntry> measures;
+        uint32_t kerningReplaced = 0; // Since the table last grew
+        uint32_t measureReplaced = 0;
+        uint32_t cacheClock = 0;
+    };
+}
@@ -0,0 +1,66 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace ogui
+{
+    FrameArena::FrameArena(size_t blockSize)
+    {
+        blocks.push_back({ static_cast<uint8_t *>(std::malloc(blockSize)), blockSize });
+    }
+
+    FrameArena::~FrameArena()
+    {
+        for (const auto &block : blocks) std::free(block.pData);
+    }
+
+    void *FrameArena::allocate(size_t size, size_t alignment)
+    {
+        assert(alignment && !(alignment & (alignment - 1)) && "Alignment must be a power of 2.");
+
+        auto pBlock = &blocks.back();
+        auto padding = (alignment - (((uintptr_t)pBlock->pData + offset) & (alignment - 1))) & (alignment - 1);
+        if (offset + padding + size > pBlock->size)
+        {
+            // Chain a new block. Worst case padding is accounted for, malloc only guarantees max_align_t.
+            auto blockSize = std::max(pBlock->size * 2, size + alignment);
+            blocks.push_back({ static_cast<uint8_t *>(std::malloc(blockSize)), blockSize });
+            pBlock = &blocks.back();
+            offset = 0;
+            padding = (alignment - ((uintptr_t)pBlock->pData & (alignment - 1))) & (alignment - 1);
+        }
+
+        auto p = pBlock->pData + offset + padding;
+        offset += padding + size;
+        used += size;
+        return p;
+    }
+
+    void FrameArena::reset()
+    {
+        used = 0;
+        offset = 0;
+
+        // The frame didn't fit, replace the chain with one block that will
+        if (blocks.size() > 1)
+        {
+            size_t blockSize = 0;
+            for (const auto &block : blocks)
+            {
+                blockSize += block.size;
+                std::free(block.pData);
+            }
+            blocks.clear();
+            blocks.push_back({ static_cast<uint8_t *>(std::malloc(blockSize)), blockSize });
+        }
+    }
+
+    size_t FrameArena::getCapacity() const
+    {
+        size_t capacity = 0;
+        for (const auto &block : blocks) capacity += block.size;
+        return capacity;
+    }
+}
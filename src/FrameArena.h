@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+namespace ogui
+{
+    // Bump allocator for data that only lives until the end of the frame. Reset at the start of Context::render().
+    // Memory is never freed individually. When the first block overflows, more blocks are chained, and on reset
+    // they are replaced by a single block big enough for the whole frame, so steady state frames never call malloc.
+    class FrameArena final
+    {
+    public:
+        FrameArena(size_t blockSize = 64 * 1024);
+        ~FrameArena();
+
+        void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        void reset();
+
+        size_t getUsed() const { return used; }
+        size_t getCapacity() const;
+
+    private:
+        struct Block
+        {
+            uint8_t *pData;
+            size_t size;
+        };
+
+        std::vector<Block> blocks; // Current block is the last one
+        size_t offset = 0;         // In the current block
+        size_t used = 0;           // Since the last reset
+    };
+
+    // STL allocator drawing from a FrameArena. Containers using it must not outlive the frame.
+    template<typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(FrameArena *in_pArena) : pArena(in_pArena) {}
+        template<typename U> ArenaAllocator(const ArenaAllocator<U> &other) : pArena(other.pArena) {}
+
+        T *allocate(size_t count) { return static_cast<T *>(pArena->allocate(sizeof(T) * count, alignof(T))); }
+        void deallocate(T * /*p*/, size_t /*count*/) {} // Freed all at once by FrameArena::reset()
+
+        template<typename U> bool operator==(const ArenaAllocator<U> &other) const { return pArena == other.pArena; }
+        template<typename U> bool operator!=(const ArenaAllocator<U> &other) const { return pArena != other.pArena; }
+
+        FrameArena *pArena;
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
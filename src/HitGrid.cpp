@@ -0,0 +1,114 @@
+#include "HitGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ogui
+{
+    void HitGrid::resize(float width, float height)
+    {
+        auto newCellsX = std::max(1u, (uint32_t)std::ceil(width / (float)CELL_SIZE));
+        auto newCellsY = std::max(1u, (uint32_t)std::ceil(height / (float)CELL_SIZE));
+        if (newCellsX == cellsX && newCellsY == cellsY) return;
+
+        for (auto &cell : cells) cell.clear();
+        cellsX = newCellsX;
+        cellsY = newCellsY;
+        cells.resize(cellsX * cellsY);
+        for (uint32_t item = 0; item < (uint32_t)items.size(); ++item)
+        {
+            if (items[item].type != eHitType::None) link(item);
+        }
+    }
+
+    uint32_t HitGrid::insert(eHitType type, uintptr_t data, const Rect &rect)
+    {
+        uint32_t item;
+        if (!freeItems.empty())
+        {
+            item = freeItems.back();
+            freeItems.pop_back();
+        }
+        else
+        {
+            item = (uint32_t)items.size();
+            items.emplace_back();
+        }
+
+        auto &hitItem = items[item];
+        hitItem.type = type;
+        hitItem.data = data;
+        hitItem.rect = rect;
+        link(item);
+        return item;
+    }
+
+    void HitGrid::update(uint32_t item, const Rect &rect)
+    {
+        auto &hitItem = items[item];
+        if (hitItem.rect.x == rect.x && hitItem.rect.y == rect.y && hitItem.rect.w == rect.w && hitItem.rect.h == rect.h) return;
+
+        unlink(item);
+        hitItem.rect = rect;
+        link(item);
+    }
+
+    void HitGrid::remove(uint32_t item)
+    {
+        unlink(item);
+        items[item].type = eHitType::None;
+        freeItems.push_back(item);
+    }
+
+    const HitItem *HitGrid::query(float x, float y) const
+    {
+        if (x < 0.0f || y < 0.0f) return nullptr;
+        auto cellX = (uint32_t)(x / (float)CELL_SIZE);
+        auto cellY = (uint32_t)(y / (float)CELL_SIZE);
+        if (cellX >= cellsX || cellY >= cellsY) return nullptr;
+
+        const HitItem *pHit = nullptr;
+        for (auto item : cells[cellY * cellsX + cellX])
+        {
+            const auto &hitItem = items[item];
+            const auto &rect = hitItem.rect;
+            if (x < rect.x || y < rect.y || x >= rect.x + rect.w || y >= rect.y + rect.h) continue;
+            if (!pHit || hitItem.type > pHit->type) pHit = &hitItem;
+        }
+        return pHit;
+    }
+
+    void HitGrid::link(uint32_t item)
+    {
+        auto &hitItem = items[item];
+        const auto &rect = hitItem.rect;
+        hitItem.cellX1 = hitItem.cellX2 = hitItem.cellY1 = hitItem.cellY2 = 0;
+        if (rect.w <= 0.0f || rect.h <= 0.0f || !cellsX) return;
+
+        auto cellSize = (float)CELL_SIZE;
+        hitItem.cellX1 = (uint32_t)std::min(std::max(std::floor(rect.x / cellSize), 0.0f), (float)cellsX);
+        hitItem.cellY1 = (uint32_t)std::min(std::max(std::floor(rect.y / cellSize), 0.0f), (float)cellsY);
+        hitItem.cellX2 = (uint32_t)std::min(std::max(std::ceil((rect.x + rect.w) / cellSize), 0.0f), (float)cellsX);
+        hitItem.cellY2 = (uint32_t)std::min(std::max(std::ceil((rect.y + rect.h) / cellSize), 0.0f), (float)cellsY);
+        for (auto cellY = hitItem.cellY1; cellY < hitItem.cellY2; ++cellY)
+        {
+            for (auto cellX = hitItem.cellX1; cellX < hitItem.cellX2; ++cellX) cells[cellY * cellsX + cellX].push_back(item);
+        }
+    }
+
+    void HitGrid::unlink(uint32_t item)
+    {
+        const auto &hitItem = items[item];
+        for (auto cellY = hitItem.cellY1; cellY < hitItem.cellY2; ++cellY)
+        {
+            for (auto cellX = hitItem.cellX1; cellX < hitItem.cellX2; ++cellX)
+            {
+                // Order in a cell doesn't matter
+                auto &cell = cells[cellY * cellsX + cellX];
+                auto it = std::find(cell.begin(), cell.end(), item);
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
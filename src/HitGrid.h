@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ogui/types.h"
+#include <cinttypes>
+#include <vector>
+
+namespace ogui
+{
+    // When items overlap, the highest type wins
+    enum class eHitType : uint8_t
+    {
+        None,
+        Zone,   // data is the zone node
+        Split,  // data is the split node, the rect is its handle
+        Tab     // data is the Panel
+    };
+
+    struct HitItem
+    {
+        eHitType    type = eHitType::None;
+        uintptr_t   data = 0;
+        Rect        rect = { 0.0f, 0.0f, 0.0f, 0.0f };
+        uint32_t    cellX1 = 0, cellY1 = 0, cellX2 = 0, cellY2 = 0; // Cells the item is linked in, 2 is exclusive
+    };
+
+    // Uniform grid over the view. Items are linked in every cell their rect touches, and are only moved between
+    // cells when their rect changes, so hit-testing a point looks at the few items of one cell.
+    class HitGrid final
+    {
+    public:
+        static const uint32_t NONE = 0xFFFFFFFF;
+        static const uint32_t CELL_SIZE = 64;
+
+        void resize(float width, float height);
+        uint32_t insert(eHitType type, uintptr_t data, const Rect &rect);
+        void update(uint32_t item, const Rect &rect);
+        void remove(uint32_t item);
+        const HitItem *query(float x, float y) const;
+
+    private:
+        void link(uint32_t item);
+        void unlink(uint32_t item);
+
+        std::vector<HitItem> items;
+        std::vector<uint32_t> freeItems;
+        std::vector<std::vector<uint32_t>> cells;
+        uint32_t cellsX = 0, cellsY = 0;
+    };
+}
@@ -0,0 +1,83 @@
+#include "InputQueue.h"
+
+namespace ogui
+{
+    InputQueue::InputQueue()
+    {
+        events.reserve(CAPACITY);
+    }
+
+    InputEvent *InputQueue::mergeable(eInputType type)
+    {
+        if (events.empty() || events.back().type != type) return nullptr;
+        return &events.back();
+    }
+
+    void InputQueue::push(eInputType type, int x, int y)
+    {
+        auto now = std::chrono::steady_clock::now();
+        ++receivedCount;
+        auto pLast = mergeable(type);
+        switch (type)
+        {
+            case eInputType::Resize:
+            case eInputType::MouseMove:
+                if (pLast)
+                {
+                    // Only the last position matters
+                    pLast->x = x;
+                    pLast->y = y;
+                    pLast->time = now;
+                    return;
+                }
+                break;
+            case eInputType::MouseScroll:
+                if (pLast)
+                {
+                    pLast->x += x;
+                    pLast->time = now;
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+
+        InputEvent event;
+        event.type = type;
+        event.x = x;
+        event.y = y;
+        event.time = now;
+        events.push_back(event);
+    }
+
+    void InputQueue::pushText(const std::string &in_text)
+    {
+        auto now = std::chrono::steady_clock::now();
+        ++receivedCount;
+        auto pLast = mergeable(eInputType::TextInput);
+
+        // Text of the last event is at the end of the buffer, it can grow in place
+        text.append(in_text);
+        if (pLast)
+        {
+            pLast->textLength += (uint32_t)in_text.size();
+            pLast->time = now;
+            return;
+        }
+
+        InputEvent event;
+        event.type = eInputType::TextInput;
+        event.textOffset = (uint32_t)(text.size() - in_text.size());
+        event.textLength = (uint32_t)in_text.size();
+        event.time = now;
+        events.push_back(event);
+    }
+
+    void InputQueue::clear()
+    {
+        events.clear();
+        text.clear();
+        receivedCount = 0;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+namespace ogui
+{
+    enum class eInputType : uint8_t
+    {
+        Resize,             // x, y are the size
+        MouseMove,
+        MouseButtonDown,    // x is the button
+        MouseButtonUp,
+        MouseScroll,        // x is the scroll amount
+        KeyDown,            // x is the key
+        KeyUp,
+        TextInput           // text
+    };
+
+    struct InputEvent
+    {
+        eInputType  type;
+        int         x = 0;
+        int         y = 0;
+        uint32_t    textOffset = 0; // In InputQueue::text
+        uint32_t    textLength = 0;
+        std::chrono::steady_clock::time_point time; // Of the last event merged in
+    };
+
+    // Application events received since the last render(). Consecutive moves, resizes and text inputs replace or
+    // extend the last event, consecutive scrolls add up. Button and key events keep their order. The queue never
+    // holds more than CAPACITY events, the Context handles them right away when it is full.
+    class InputQueue final
+    {
+    public:
+        static const uint32_t CAPACITY = 256;
+
+        InputQueue();
+
+        bool isFull() const { return events.size() >= CAPACITY; }
+        bool empty() const { return events.empty(); }
+        const std::vector<InputEvent> &getEvents() const { return events; }
+        const char *getText(const InputEvent &event) const { return text.data() + event.textOffset; }
+        uint32_t getReceivedCount() const { return receivedCount; } // Since the last clear, merged ones included
+
+        void push(eInputType type, int x = 0, int y = 0);
+        void pushText(const std::string &text);
+        void clear(); // Keeps the memory
+
+    private:
+        InputEvent *mergeable(eInputType type); // Last event if it is of that type
+
+        std::vector<InputEvent> events;
+        std::string text; // Of every TextInput event
+        uint32_t receivedCount = 0;
+    };
+}
@@ -0,0 +1,81 @@
+#include "InvalidateQueue.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace ogui
+{
+    template<typename T>
+    static void PushUnique(std::vector<std::weak_ptr<T>> &targets, const std::shared_ptr<T> &pTarget)
+    {
+        // Few targets are pending at once, a background job usually posts the same one over and over
+        for (const auto &target : targets)
+        {
+            if (!target.owner_before(pTarget) && !pTarget.owner_before(target)) return;
+        }
+        targets.push_back(pTarget);
+    }
+
+    void InvalidateQueue::setWakeCallback(const std::function<void()> &callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeCallback = callback;
+    }
+
+    void InvalidateQueue::postDirty()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isDirtyPosted = true;
+        }
+        wake();
+    }
+
+    void InvalidateQueue::post(const std::shared_ptr<Panel> &pPanel)
+    {
+        if (!pPanel) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            PushUnique(postedPanels, pPanel);
+        }
+        wake();
+    }
+
+    void InvalidateQueue::post(const std::shared_ptr<Widget> &pWidget)
+    {
+        if (!pWidget) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            PushUnique(postedWidgets, pWidget);
+        }
+        wake();
+    }
+
+    void InvalidateQueue::wake()
+    {
+        // Set after the target was added and cleared before take() locks, so a post racing with take() either makes
+        // it into this frame or wakes for the next one
+        if (isPosted.exchange(true, std::memory_order_acq_rel)) return;
+
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            callback = wakeCallback;
+        }
+        if (callback) callback();
+    }
+
+    bool InvalidateQueue::take(bool &isDirty, ArenaVector<std::weak_ptr<Panel>> &panels, ArenaVector<std::weak_ptr<Widget>> &widgets)
+    {
+        if (!isPosted.exchange(false, std::memory_order_acq_rel)) return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        isDirty = isDirtyPosted;
+        isDirtyPosted = false;
+        std::move(postedPanels.begin(), postedPanels.end(), std::back_inserter(panels));
+        std::move(postedWidgets.begin(), postedWidgets.end(), std::back_inserter(widgets));
+        postedPanels.clear();
+        postedWidgets.clear();
+        return true;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FrameArena.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ogui
+{
+    class Panel;
+    class Widget;
+
+    // Invalidations posted from any thread, taken by the UI thread at the next render(). A target already posted isn't
+    // added again. Only the first post after the last take() calls the wake callback, so however many posts come in,
+    // the Application's loop is woken at most once per frame.
+    class InvalidateQueue final
+    {
+    public:
+        void setWakeCallback(const std::function<void()> &callback);
+
+        void postDirty();
+        void post(const std::shared_ptr<Panel> &pPanel);
+        void post(const std::shared_ptr<Widget> &pWidget);
+
+        // UI thread. False right away when nothing was posted. Targets are appended to the vectors.
+        bool take(bool &isDirty, ArenaVector<std::weak_ptr<Panel>> &panels, ArenaVector<std::weak_ptr<Widget>> &widgets);
+
+    private:
+        void wake(); // Once the lock is released, the callback may post
+
+        std::mutex mutex;
+        bool isDirtyPosted = false;
+        std::vector<std::weak_ptr<Panel>> postedPanels;
+        std::vector<std::weak_ptr<Widget>> postedWidgets;
+        std::function<void()> wakeCallback;
+
+        std::atomic<bool> isPosted{ false }; // Since the last take()
+    };
+}
@@ -0,0 +1,106 @@
+#include "JobPool.h"
+#include "Trace.h"
+
+namespace ogui
+{
+    JobPool::JobPool(uint32_t workerCount)
+    {
+        for (uint32_t i = 0; i <= workerCount; ++i) queues.emplace_back(new Queue());
+        for (uint32_t i = 1; i <= workerCount; ++i) threads.emplace_back([this, i]() { work(i); });
+    }
+
+    JobPool::~JobPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            isStopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto &thread : threads) thread.join();
+    }
+
+    void JobPool::run(uint32_t jobCount, const std::function<void(uint32_t)> &job)
+    {
+        if (!jobCount) return;
+        OGUI_TRACE_ZONE("JobPool::run");
+
+        // Set before dealing, a worker still looking for work from the last batch can take a job right away
+        pJob = &job;
+        remaining.store(jobCount, std::memory_order_relaxed);
+
+        // Deal the jobs, neighbours usually cost about the same so they go to different threads
+        auto queueCount = (uint32_t)queues.size();
+        for (uint32_t i = 0; i < queueCount; ++i)
+        {
+            auto &queue = *queues[i];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.clear();
+            for (auto index = i; index < jobCount; index += queueCount) queue.jobs.push_back(index);
+            queue.front = 0;
+            queue.back = queue.jobs.size();
+        }
+
+        if (jobCount > 1)
+        {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                ++batch;
+            }
+            wakeCondition.notify_all();
+        }
+
+        while (runOne(0)) {}
+
+        // Others may still be running the last jobs they took
+        if (remaining.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            doneCondition.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+        }
+        pJob = nullptr;
+    }
+
+    void JobPool::work(uint32_t queue)
+    {
+        uint64_t seenBatch = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait(lock, [&]() { return isStopping || batch != seenBatch; });
+                if (isStopping) return;
+                seenBatch = batch;
+            }
+
+            while (runOne(queue)) {}
+        }
+    }
+
+    bool JobPool::runOne(uint32_t queue)
+    {
+        uint32_t job;
+        auto queueCount = (uint32_t)queues.size();
+        auto found = pop(queue, true, &job);
+        for (uint32_t i = 1; i < queueCount && !found; ++i) found = pop((queue + i) % queueCount, false, &job);
+        if (!found) return false;
+
+        (*pJob)(job);
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Lock so the notification can't slip between run()'s check and its wait
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            doneCondition.notify_all();
+        }
+        return true;
+    }
+
+    bool JobPool::pop(uint32_t index, bool isOwner, uint32_t *pIndex)
+    {
+        auto &queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.front == queue.back) return false;
+        *pIndex = isOwner ? queue.jobs[queue.front++] : queue.jobs[--queue.back];
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ogui
+{
+    // Runs a batch of indexed jobs on worker threads, the calling thread included. Jobs are dealt to one queue per
+    // thread. A thread takes jobs from the front of its own queue, and when it is empty, steals from the back of the
+    // others, so uneven jobs still keep every thread busy.
+    class JobPool final
+    {
+    public:
+        JobPool(uint32_t workerCount); // Threads besides the calling one
+        ~JobPool();
+
+        uint32_t getThreadCount() const { return (uint32_t)queues.size(); }
+
+        // Blocks until every job ran. Not reentrant, jobs must not call run().
+        void run(uint32_t jobCount, const std::function<void(uint32_t)> &job);
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::vector<uint32_t> jobs;
+            size_t front = 0; // Jobs left are [front, back)
+            size_t back = 0;
+        };
+
+        void work(uint32_t queue); // Worker thread
+        bool runOne(uint32_t queue);
+        bool pop(uint32_t queue, bool isOwner, uint32_t *pIndex);
+
+        std::vector<std::unique_ptr<Queue>> queues; // queues[0] belongs to the calling thread
+        std::vector<std::thread> threads;
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        std::condition_variable doneCondition;
+        uint64_t batch = 0; // Incremented by every run(), wakes the workers
+        bool isStopping = false;
+
+        const std::function<void(uint32_t)> *pJob = nullptr;
+        std::atomic<uint32_t> remaining{ 0 };
+    };
+}
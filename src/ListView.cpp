@@ -0,0 +1,50 @@
+#include "ListView.h"
+#include "Context.h"
+
+namespace ogui
+{
+    IListViewRef IListView::create(IListDataSource *pDataSource)
+    {
+        return std::shared_ptr<ListView>(new ListView(pDataSource));
+    }
+
+    ListView::ListView(IListDataSource *in_pDataSource)
+        : pDataSource(in_pDataSource)
+    {
+        count = pDataSource ? pDataSource->getCount() : 0;
+    }
+
+    void ListView::setDataSource(IListDataSource *in_pDataSource)
+    {
+        pDataSource = in_pDataSource;
+        refresh();
+    }
+
+    void ListView::refresh()
+    {
+        count = pDataSource ? pDataSource->getCount() : 0;
+        rows.invalidate();
+        invalidate();
+    }
+
+    Vec2 ListView::measure(Context *pContext, const Vec2 &available)
+    {
+        return { available.x, (float)((double)count * (double)pContext->theme.listItemHeight) };
+    }
+
+    void ListView::arrange(Context *pContext, const Rect &in_rect, const Rect &viewport)
+    {
+        rect = in_rect;
+        rows.update(getTop(), viewport, pContext->theme.listItemHeight, count, [this](VirtualRow &row)
+        {
+            row.item = row.index;
+            row.text.clear();
+            pDataSource->getText(row.index, row.text);
+        });
+    }
+
+    void ListView::render(Context *pContext)
+    {
+        rows.render(pContext, rect, false);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ogui/IListView.h"
+#include "VirtualRows.h"
+
+namespace ogui
+{
+    class ListView final : public IListView
+    {
+    public:
+        ListView(IListDataSource *pDataSource);
+
+        void setDataSource(IListDataSource *pDataSource) override;
+        void refresh() override;
+
+        Vec2 measure(Context *pContext, const Vec2 &available) override;
+        void arrange(Context *pContext, const Rect &rect, const Rect &viewport) override;
+        void render(Context *pContext) override;
+
+    private:
+        IListDataSource *pDataSource = nullptr;
+        uint32_t count = 0;
+        VirtualRows rows;
+    };
+}
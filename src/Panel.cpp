@@ -1,7 +1,11 @@
 #include "Panel.h"
-#include "ogui/IContext.h"
+#include "Context.h"
 #include "ogui/Widget.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace ogui
 {
     IPanelRef IPanel::create()
@@ -15,85 +19,255 @@ namespace ogui
 
     Panel::~Panel()
     {
+        for (const auto &pWidget : widgets) pWidget->pPanel = nullptr;
     }
 
     void Panel::setTitle(const std::string &in_title)
     {
+        if (title == in_title) return;
         title = in_title;
+        ++version;
+
+        // Tab widths depend on the title, only its zone needs it
+        if (updateDepth) isTabLayoutPending = true;
+        else if (pContext) pContext->updateLayout(this);
     }
 
     void Panel::clear()
     {
         if (widgets.empty()) return;
 
+        for (const auto &pWidget : widgets)
+        {
+            pWidget->pPanel = nullptr;
+            if (pContext) pContext->unhover(pWidget.get());
+        }
         widgets.clear();
         
-        updateLayout(clientRect);
+        invalidateLayout();
     }
 
     void Panel::add(const WidgetRef &pWidget)
     {
         if (!pWidget) return;
-
-        widgets.push_back(pWidget);
+        adopt(pWidget);
+        if (!widgets.pushBack(pWidget)) return;
+        pWidget->pPanel = this;
         
-        updateLayout(clientRect);
+        invalidateLayout();
     }
 
     void Panel::insertBefore(const WidgetRef &pWidget, const WidgetRef &pBefore)
     {
         if (!pWidget) return;
-
-        auto it = widgets.begin();
-        for (; it != widgets.end(); ++it)
-        {
-            if (*it == pBefore)
-            {
-                break;
-            }
-        }
-        widgets.insert(it, pWidget);
+        adopt(pWidget);
+        if (!widgets.insertBefore(pWidget, pBefore.get())) return;
+        pWidget->pPanel = this;
         
-        updateLayout(clientRect);
+        invalidateLayout();
     }
 
     void Panel::insertAfter(const WidgetRef &pWidget, const WidgetRef &pAfter)
     {
         if (!pWidget) return;
+        adopt(pWidget);
+        if (!widgets.insertAfter(pWidget, pAfter.get())) return;
+        pWidget->pPanel = this;
+        
+        invalidateLayout();
+    }
+
+    void Panel::remove(const WidgetRef &pWidget)
+    {
+        if (!widgets.remove(pWidget.get())) return;
+        pWidget->pPanel = nullptr;
+        if (pContext) pContext->unhover(pWidget.get());
+
+        invalidateLayout();
+    }
+
+    void Panel::beginUpdate()
+    {
+        ++updateDepth;
+    }
 
-        auto it = widgets.begin();
-        for (; it != widgets.end(); ++it)
+    void Panel::endUpdate()
+    {
+        if (!updateDepth || --updateDepth) return;
+
+        if (isTabLayoutPending && pContext)
         {
-            if (*it == pAfter)
-            {
-                ++it;
-                break;
-            }
+            pContext->updateLayout(this); // Also lays out the panel itself
         }
-        widgets.insert(it, pWidget);
-        
-        updateLayout(clientRect);
+        else if (isLayoutPending)
+        {
+            updateLayout(clientRect);
+        }
+        isTabLayoutPending = false;
+        isLayoutPending = false;
     }
 
-    void Panel::remove(const WidgetRef &pWidget)
+    void Panel::invalidateLayout()
     {
-        if (!pWidget) return;
+        isWidgetLayoutDirty = true; // arrangedWidgets can hold removed widgets, even during a batch
+        if (updateDepth) isLayoutPending = true;
+        else updateLayout(clientRect);
+    }
 
-        for (auto it = widgets.begin(); it != widgets.end(); ++it)
+    void Panel::updateLayout(const Rect &rect)
+    {
+        ++version;
+        isLayoutPending = false;
+        isWidgetLayoutDirty = true;
+        if (pContext)
         {
-            if (*it == pWidget)
+            pContext->setDirty(clientRect);
+            pContext->setDirty(rect);
+        }
+
+        clientRect = rect;
+    }
+
+    void Panel::adopt(const WidgetRef &pWidget)
+    {
+        if (pWidget->pPanel && pWidget->pPanel != this) pWidget->pPanel->remove(pWidget);
+    }
+
+    void Panel::setScrollOffset(double in_scrollOffset)
+    {
+        in_scrollOffset = std::max(0.0, in_scrollOffset);
+        if (in_scrollOffset == scrollOffset) return;
+
+        // Widgets don't change, only what is in view. Clamped to the content at layout.
+        scrollOffset = in_scrollOffset;
+        isScrollDirty = true;
+        if (pContext) pContext->setDirty(clientRect);
+    }
+
+    void Panel::layoutWidgets()
+    {
+        if (!isWidgetLayoutDirty)
+        {
+            scrollWidgets();
+            return;
+        }
+        isWidgetLayoutDirty = false;
+        isScrollDirty = false;
+
+        // Measure. Widgets stack top to bottom, their total height limits how far the panel scrolls.
+        // Only widgets that changed, or when the width or the theme changed, are measured again.
+        const auto &theme = pContext->theme;
+        Vec2 available = { std::max(0.0f, clientRect.w - theme.panelPadding * 2.0f), std::numeric_limits<float>::infinity() };
+        double top = theme.panelPadding;
+        arrangedWidgets.clear();
+        widgetTops.clear();
+        for (const auto &pWidget : widgets)
+        {
+            arrangedWidgets.push_back(pWidget.get());
+            widgetTops.push_back(top);
+            top += (double)pWidget->measureCached(pContext, available).y + theme.controlSpacing;
+        }
+        if (!widgets.empty()) top -= theme.controlSpacing;
+        contentHeight = top + theme.panelPadding;
+        scrollOffset = std::min(scrollOffset, std::max(0.0, contentHeight - clientRect.h));
+
+        // Arrange. Widgets that didn't move, and whose visible part is the same, are skipped.
+        for (uint32_t i = 0; i < (uint32_t)arrangedWidgets.size(); ++i) arrangeWidget(i);
+        updateVisibleWidgets();
+    }
+
+    void Panel::scrollWidgets()
+    {
+        isScrollDirty = false;
+        scrollOffset = std::min(scrollOffset, std::max(0.0, contentHeight - clientRect.h));
+
+        // Widgets in view moved, and the ones that left are told so. The others keep their rect until they are back.
+        auto previousFirst = firstVisibleWidget;
+        auto previousLast = lastVisibleWidget;
+        updateVisibleWidgets();
+        for (auto i = firstVisibleWidget; i < lastVisibleWidget; ++i) arrangeWidget(i);
+        for (auto i = previousFirst; i < previousLast; ++i)
+        {
+            if (i < firstVisibleWidget || i >= lastVisibleWidget) arrangeWidget(i);
+        }
+    }
+
+    void Panel::arrangeWidget(uint32_t index)
+    {
+        const auto &theme = pContext->theme;
+        auto pWidget = arrangedWidgets[index];
+        auto y = getContentOrigin() + widgetTops[index];
+        Rect rect = { clientRect.x + theme.panelPadding, (float)y, std::max(0.0f, clientRect.w - theme.panelPadding * 2.0f), pWidget->measuredSize.y };
+        pWidget->arrangeCached(pContext, rect, y, clientRect);
+    }
+
+    void Panel::updateVisibleWidgets()
+    {
+        // Whole pixels, like the scissor renderWidgets draws them in
+        auto bottom = (double)std::ceil(clientRect.y + clientRect.h) - getContentOrigin();
+        firstVisibleWidget = findWidget(std::floor(clientRect.y));
+        lastVisibleWidget = firstVisibleWidget;
+        while (lastVisibleWidget < (uint32_t)arrangedWidgets.size() && widgetTops[lastVisibleWidget] < bottom) ++lastVisibleWidget;
+    }
+
+    uint32_t Panel::findWidget(double y) const
+    {
+        // Widgets are sorted top to bottom, y can be in the spacing above the one found
+        y -= getContentOrigin();
+        uint32_t first = 0;
+        auto count = (uint32_t)arrangedWidgets.size();
+        while (count)
+        {
+            auto half = count / 2;
+            auto index = first + half;
+            if (widgetTops[index] + arrangedWidgets[index]->measuredSize.y <= y)
             {
-                widgets.erase(it);
-                updateLayout(clientRect);
-                break;
+                first = index + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
             }
         }
+        return first;
     }
 
-    void Panel::updateLayout(const Rect &rect)
+    Widget *Panel::hitTest(float x, float y)
     {
-        if (pContext) pContext->setDirty();
+        if (x < clientRect.x || y < clientRect.y || x >= clientRect.x + clientRect.w || y >= clientRect.y + clientRect.h) return nullptr;
+        if (isWidgetLayoutNeeded()) layoutWidgets(); // Removed widgets may be gone
 
-        clientRect = rect;
+        // Widgets in view were arranged by the last layout, their rects are current
+        auto index = findWidget(y);
+        if (index == (uint32_t)arrangedWidgets.size()) return nullptr;
+        auto pWidget = arrangedWidgets[index];
+        const auto &rect = pWidget->getRect();
+        if (y < rect.y || x < rect.x || x >= rect.x + rect.w) return nullptr;
+        return pWidget;
+    }
+
+    void Panel::renderWidgets()
+    {
+        if (widgets.empty() || !pContext->isDamaged(clientRect)) return;
+        if (isWidgetLayoutNeeded()) layoutWidgets();
+
+        // Clip to the client area, within the area being redrawn
+        const auto &damage = pContext->currentDamage;
+        auto x1 = std::max(std::floor(clientRect.x), damage.x);
+        auto y1 = std::max(std::floor(clientRect.y), damage.y);
+        auto x2 = std::min(std::ceil(clientRect.x + clientRect.w), damage.x + damage.w);
+        auto y2 = std::min(std::ceil(clientRect.y + clientRect.h), damage.y + damage.h);
+        if (x2 <= x1 || y2 <= y1) return;
+        pContext->scissor({ x1, y1, x2 - x1, y2 - y1 });
+
+        // Start at the first widget ending below the top of the area, like hitTest. All of them are in view.
+        auto origin = getContentOrigin();
+        for (auto i = findWidget(y1); i < (uint32_t)arrangedWidgets.size() && origin + widgetTops[i] < y2; ++i)
+        {
+            arrangedWidgets[i]->render(pContext);
+        }
+
+        pContext->scissor(damage);
     }
 }
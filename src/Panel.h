@@ -2,12 +2,13 @@
 
 #include "ogui/IPanel.h"
 #include "ogui/types.h"
+#include "WidgetList.h"
 #include <memory>
 #include <vector>
 
 namespace ogui
 {
-    class IContext;
+    class Context;
 
     class Panel final : public IPanel
     {
@@ -22,15 +23,42 @@ namespace ogui
         void insertBefore(const WidgetRef &pWidget, const WidgetRef &pBefore) override;
         void insertAfter(const WidgetRef &pWidget, const WidgetRef &pAfter) override;
         void remove(const WidgetRef &pWidget) override;
+        void beginUpdate() override;
+        void endUpdate() override;
+        void setScrollOffset(double scrollOffset) override;
+        double getScrollOffset() const override { return scrollOffset; }
 
         void updateLayout(const Rect &rect);
+        void invalidateLayout();
+        void layoutWidgets(); // Lazily, when the panel is rendered
+        bool isWidgetLayoutNeeded() const { return isWidgetLayoutDirty || isScrollDirty; }
+        void scrollWidgets(); // Only what comes into or goes out of view is arranged
+        void arrangeWidget(uint32_t index);
+        void updateVisibleWidgets();
+        uint32_t findWidget(double y) const; // First of arrangedWidgets ending below y, in view coordinates
+        double getContentOrigin() const { return (double)clientRect.y - scrollOffset; } // widgetTops are relative to it
+        void renderWidgets();
+        Widget *hitTest(float x, float y); // Widget under a point of the client area, if any
+        void adopt(const WidgetRef &pWidget); // Takes the widget out of the panel it is in, if another one
 
-        IContext *pContext = nullptr;
+        Context *pContext = nullptr;
         Rect tabRect = { 0.0f, 0.0f, 0.0f, 0.0f };
+        uint32_t hitItem = 0xFFFFFFFF; // Tab in PanelsManager::hit_grid, while docked
         Rect clientRect = { 0.0f, 0.0f, 0.0f, 0.0f };
-        float scrollOffset = 0.0f;
-        std::vector<WidgetRef> widgets;
+        double scrollOffset = 0.0;
+        double contentHeight = 0.0; // Of the widgets, at the last layout. Widgets are placed in double too, tall lists scroll millions of pixels.
+        WidgetList widgets;
+        std::vector<Widget *> arrangedWidgets; // Same order as widgets, as of the last layout
+        std::vector<double> widgetTops; // Of arrangedWidgets, from the top of the content. Binary searched by hitTest and renderWidgets.
+        uint32_t firstVisibleWidget = 0; // Of arrangedWidgets in view
+        uint32_t lastVisibleWidget = 0;  // Exclusive
+        bool isWidgetLayoutDirty = true; // Widgets are measured and arranged again
+        bool isScrollDirty = false; // Only the scroll offset changed since the last layout
         std::string title = "Panel";
         bool hasCloseButton = false;
+        uint32_t version = 0; // Incremented every time the panel's visual changes
+        uint32_t updateDepth = 0; // Nested beginUpdate() calls
+        bool isLayoutPending = false;
+        bool isTabLayoutPending = false;
     };
 }
@@ -1,737 +1,555 @@
 #include "PanelsManager.h"
 #include "Panel.h"
+#include "Atlas.h"
 #include "Context.h"
+#include "Font.h"
+#include "FrameArena.h"
+#include "JobPool.h"
+#include "Trace.h"
+
+#include <algorithm>
 
 namespace ogui
 {
-    DockZone::DockZone(const std::vector<PanelRef>& in_panels, int in_active_panel)
-        : panels(in_panels)
-        , active_panel(in_active_panel)
+    uint64_t DockZone::getVersion() const
     {
+        // Versions only go up, mix them so the result changes as soon as one of them does
+        uint64_t ret = version;
+        for (const auto &pPanel : panels) ret = ret * 1099511628211ull + pPanel->version;
+        return ret;
     }
 
-    DockHSplit::DockHSplit(DockNodeRef in_left, DockNodeRef in_right, float in_amount, eDockMagnet in_magnet)
-        : left(in_left)
-        , right(in_right)
-        , amount(in_amount)
-        , magnet(in_magnet)
+    PanelsManager::PanelsManager()
     {
+        // We only start with document's view
+        document_zone = allocNode(eDockNodeType::Zone);
+        auto &zone = getZone(document_zone);
+        zone.keep_around = true;
+        zone.text = "Documents View";
+        dock_root = document_zone;
     }
 
-    DockVSplit::DockVSplit(DockNodeRef in_top, DockNodeRef in_bottom, float in_amount, eDockMagnet in_magnet)
-        : top(in_top)
-        , bottom(in_bottom)
-        , amount(in_amount)
-        , magnet(in_magnet)
+    PanelsManager::~PanelsManager()
     {
     }
 
-    DockKeepAround::DockKeepAround(const std::string& in_text, const std::vector<PanelRef>& panels, int active_panel)
-        : DockZone(panels, active_panel)
-        , text(in_text)
-    {
-    }
-    
-    void DockKeepAround::render(Context* ctx)
+    uint32_t PanelsManager::allocNode(eDockNodeType type)
     {
-#if 0
-        if (panels.empty())
+        uint32_t node;
+        if (free_node != DOCK_NULL)
         {
-            ctx->drawText(ctx->theme->font, text, ctx->rect.Center(), OCenter, ctx->theme->disabled_text_color);
+            node = free_node;
+            free_node = nodes[node].children[0];
+            nodes[node] = DockNode();
         }
         else
         {
-            DockZone::render(ctx);
+            node = (uint32_t)nodes.size();
+            nodes.push_back(DockNode());
         }
-#endif
+
+        nodes[node].type = type;
+        if (type == eDockNodeType::Zone) nodes[node].zone = allocZone(node);
+        nodes[node].hit_item = hit_grid.insert(type == eDockNodeType::Zone ? eHitType::Zone : eHitType::Split, node, nodes[node].rect);
+        return node;
     }
 
-    void DockZone::updateLayout(const Rect &parentRect, Context* ctx)
+    uint32_t PanelsManager::allocZone(uint32_t node)
     {
-        for (int i = 0, len = (int)panels.size(); i < len; ++i)
+        uint32_t index;
+        if (!free_zones.empty())
         {
-            const auto &pPanel = panels[i];
-
-            auto clientRect = parentRect;
-            clientRect.y += ctx->theme.controlHeight;
-            clientRect.h -= ctx->theme.controlHeight;
-            pPanel->updateLayout(clientRect);
-
-            auto tabRect = parentRect;
-            tabRect.h = ctx->theme.controlHeight;
-            auto textSize = 32.0f; // TODO
-            auto width = textSize + ctx->theme.tabPadding * 2.0f;
-            auto fullWidth = width + (
-            pPanel->tabRect = tabRect;
+            index = free_zones.back();
+            free_zones.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)zones.size();
+            zones.emplace_back();
         }
-    }
-
-    void DockHSplit::updateLayout(const Rect &parentRect, Context* ctx)
-    {
-    }
 
-    void DockVSplit::updateLayout(const Rect &parentRect, Context* ctx)
-    {
+        // Reused zones keep their vectors' capacity
+        auto &zone = zones[index];
+        zone.node = node;
+        zone.active_panel = 0;
+        zone.keep_around = false;
+        zone.text.clear();
+        ++zone.version;
+        return index;
     }
 
-    void DockZone::render(Context* ctx)
+    void PanelsManager::freeNode(uint32_t node)
     {
-#if 0
-        if (panels.empty()) return;
-
-        // Draw active panel
-        {
-            ctx->pushRect();
-            ctx->rect.y += ctx->theme->control_height;
-            ctx->rect.w -= ctx->theme->control_height;
-            ctx->drawPanel();
-            ctx->rect = ctx->rect.Grow(-ctx->theme->panel_padding);
-            panels[active_panel]->render(ctx);
-            ctx->popRect();
-        }
-
-        // Draw tabs
+        auto &dockNode = nodes[node];
+        if (dockNode.type == eDockNodeType::Zone)
         {
-            ctx->pushRect();
-            ctx->rect.w = ctx->theme->control_height;
-            float tab_offset = 0.0f;
-            for (int i = 0; i < (int)panels.size() && tab_offset < ctx->rect.z; ++i)
+            auto &zone = zones[dockNode.zone];
+            for (const auto &pPanel : zone.panels)
             {
-                const auto& panel = panels[i];
-                eUIState ui_state;
-                if (i == active_panel)
-                {
-                    ui_state = ctx->drawActiveTab(panels[i]->name, tab_offset, panel->closable);
-                    if (ui_state == eUIState::Down)
-                    {
-                        auto scene_view = ODynamicCast<SceneViewPanel>(panel);
-                        if (scene_view) g_panels_mgr->focussed_scene_view = scene_view;
-                    }
-                }
-                else
-                {
-                    auto offset_before = tab_offset;
-                    ui_state = ctx->drawInactiveTab(panels[i]->name, tab_offset, panel->closable);
-                    if (ui_state == eUIState::Down)
-                    {
-                        active_panel = i;
-                        auto scene_view = ODynamicCast<SceneViewPanel>(panel);
-                        if (scene_view) g_panels_mgr->focussed_scene_view = scene_view;
-                    }
-                }
-                if (ui_state == eUIState::Close)
-                {
-                    auto panel_to_close = panel;
-
-                    panels.erase(panels.begin() + i);
-                    g_panels_mgr->closed_panel = true;
-                    active_panel = std::min(i, (int)panels.size() - 1);
-                    --i;
-
-                    if (g_panels_mgr->focussed_scene_view == panel) g_panels_mgr->focussed_scene_view = nullptr;
-                    if (!panels.empty())
-                    {
-                        auto new_active_panel = panels[active_panel];
-                        auto scene_view = ODynamicCast<SceneViewPanel>(new_active_panel);
-                        if (scene_view) g_panels_mgr->focussed_scene_view = scene_view;
-                    }
-                }
-                else if (ui_state == eUIState::Drag || ui_state == eUIState::Drop)
-                {
-                    g_panels_mgr->dragging_panel = panel;
-                    g_panels_mgr->dropped_panel = ui_state == eUIState::Drop;
-                }
+                panel_index.erase(pPanel.get());
+                hit_grid.remove(pPanel->hitItem);
+                pPanel->hitItem = DOCK_NULL;
             }
-            ctx->popRect();
+            zone.panels.clear();
+            zone.cache.textures.clear();
+            zone.cache.version = ~0ull;
+            zone.node = DOCK_NULL;
+            free_zones.push_back(dockNode.zone);
         }
 
-        // Zone options (none for now)
-        //{
-        //    ctx->drawToolButton(ctx->theme->menu_icon, Vector2(
-        //        ctx->rect.x + ctx->rect.z - ctx->theme->tool_button_size, 
-        //        ctx->rect.y + (ctx->theme->control_height - ctx->theme->tool_button_size) * 0.5f));
-        //}
-#endif
+        hit_grid.remove(dockNode.hit_item);
+        dockNode.hit_item = DOCK_NULL;
+        dockNode.type = eDockNodeType::Free;
+        dockNode.children[0] = free_node;
+        free_node = node;
     }
 
-    void DockZone::dock(Context* ctx, DockContext* dock_ctx)
+    void PanelsManager::removeZone(uint32_t node)
     {
-#if 0
-        const auto& rect = ctx->rect;
-
-        Vector2 mouse_percent(
-            (ctx->mouse.x - rect.x) / rect.z,
-            (ctx->mouse.y - rect.y - ctx->theme->control_height) / (rect.w - ctx->theme->control_height));
-
-        dock_ctx->target    = OThis;
-        dock_ctx->position  = eDockPosition::Center;
-
-        float tab_offset = 0.0f;
-        float tab_width = 0.0f;
+        // The parent split collapses into the zone's sibling
+        auto split = nodes[node].parent;
+        auto sibling = nodes[split].children[0] == node ? nodes[split].children[1] : nodes[split].children[0];
+        auto grandParent = nodes[split].parent;
 
-        if (mouse_percent.y < 0)
-        {
-            dock_ctx->position = eDockPosition::Tab;
-            for (dock_ctx->tab_index = 0; dock_ctx->tab_index < (int)panels.size() && tab_offset < ctx->rect.z; ++dock_ctx->tab_index)
-            {
-                const auto& panel = panels[dock_ctx->tab_index];
-                auto text_size = ctx->theme->font->measure(panel->name);
-                tab_width = text_size.x + ctx->theme->tab_padding * 2.0f + (panel->closable ? (16.0f + ctx->theme->tab_padding) : 0.0f);
+        nodes[sibling].parent = grandParent;
+        if (grandParent == DOCK_NULL) dock_root = sibling;
+        else if (nodes[grandParent].children[0] == split) nodes[grandParent].children[0] = sibling;
+        else nodes[grandParent].children[1] = sibling;
 
-                if (ctx->mouse.x <= rect.x + tab_offset + tab_width)
-                {
-                    break;
-                }
-            
-                tab_offset += tab_width + ctx->theme->tab_spacing;
-            }
-        }
-        else if (rect.w > rect.z)
-        {
-            if (mouse_percent.y < 0.25f) dock_ctx->position = eDockPosition::Top;
-            else if (mouse_percent.y > 0.75f) dock_ctx->position = eDockPosition::Bottom;
-            else if (mouse_percent.x < 0.25f) dock_ctx->position = eDockPosition::Left;
-            else if (mouse_percent.x > 0.75f) dock_ctx->position = eDockPosition::Right;
-        }
-        else
-        {
-            if (mouse_percent.x < 0.25f) dock_ctx->position = eDockPosition::Left;
-            else if (mouse_percent.x > 0.75f) dock_ctx->position = eDockPosition::Right;
-            else if (mouse_percent.y < 0.25f) dock_ctx->position = eDockPosition::Top;
-            else if (mouse_percent.y > 0.75f) dock_ctx->position = eDockPosition::Bottom;
-        }
+        freeNode(split);
+        freeNode(node);
+    }
 
-        switch (dock_ctx->position)
+    void PanelsManager::reindexZone(uint32_t zoneIndex, int from)
+    {
+        // Tabs after an insertion or removal moved by one
+        const auto &panels = zones[zoneIndex].panels;
+        for (int i = from, len = (int)panels.size(); i < len; ++i)
         {
-            case eDockPosition::Center:
-                ctx->drawRect(nullptr, rect, ctx->theme->dock_color);
-                break;
-            case eDockPosition::Left:
-                if (dock_ctx->left_most)
-                {
-                    dock_ctx->amount = std::min(rect.z * 0.5f, 300.0f);
-                    dock_ctx->magnet = eDockMagnet::Left;
-                }
-                else if (dock_ctx->right_most)
-                {
-                    dock_ctx->amount = std::min(rect.z * 0.5f, 300.0f);
-                    dock_ctx->magnet = eDockMagnet::Right;
-                }
-                ctx->drawRect(nullptr, {rect.x, rect.y, rect.z * 0.5f, rect.w}, ctx->theme->dock_color);
-                break;
-            case eDockPosition::Right:
-                if (dock_ctx->left_most)
-                {
-                    dock_ctx->amount = std::min(rect.z * 0.5f, 300.0f);
-                    dock_ctx->magnet = eDockMagnet::Left;
-                }
-                else if (dock_ctx->right_most)
-                {
-                    dock_ctx->amount = std::min(rect.z * 0.5f, 300.0f);
-                    dock_ctx->magnet = eDockMagnet::Right;
-                }
-                ctx->drawRect(nullptr, {rect.x + rect.z * 0.5f, rect.y, rect.z * 0.5f, rect.w}, ctx->theme->dock_color);
-                break;
-            case eDockPosition::Top:
-                if (dock_ctx->bottom_most)
-                {
-                    dock_ctx->amount = std::min(rect.w * 0.5f, 200.0f);
-                    dock_ctx->magnet = eDockMagnet::Bottom;
-                }
-                else if (dock_ctx->top_most)
-                {
-                    dock_ctx->amount = std::min(rect.w * 0.5f, 200.0f);
-                    dock_ctx->magnet = eDockMagnet::Top;
-                }
-                ctx->drawRect(nullptr, {rect.x, rect.y, rect.z, rect.w * 0.5f}, ctx->theme->dock_color);
-                break;
-            case eDockPosition::Bottom:
-                if (dock_ctx->bottom_most)
-                {
-                    dock_ctx->amount = std::min(rect.w * 0.5f, 200.0f);
-                    dock_ctx->magnet = eDockMagnet::Bottom;
-                }
-                else if (dock_ctx->top_most)
-                {
-                    dock_ctx->amount = std::min(rect.w * 0.5f, 200.0f);
-                    dock_ctx->magnet = eDockMagnet::Top;
-                }
-                ctx->drawRect(nullptr, {rect.x, rect.y + rect.w * 0.5f, rect.z, rect.w * 0.5f}, ctx->theme->dock_color);
-                break;
-            case eDockPosition::Tab:
-                ctx->drawRect(nullptr, {rect.x + tab_offset - 4.0f, rect.y, 4.0f, ctx->theme->control_height}, ctx->theme->dock_color);
-                break;
+            auto &location = panel_index[panels[i].get()];
+            location.zone = zoneIndex;
+            location.index = i;
         }
-#endif
     }
 
-    void DockHSplit::dock(Context* ctx, DockContext* dock_ctx)
+    void PanelsManager::undockPanel(const PanelRef& panel)
     {
-#if 0
-        float splitPos = (float)(int)amount;
-        if (magnet == eDockMagnet::Right) splitPos = (float)(int)(ctx->rect.z - amount);
-        else if (magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.z * amount);
+        auto it = panel_index.find(panel.get());
+        if (it == panel_index.end()) return;
+        auto location = it->second;
+        panel_index.erase(it);
+        hit_grid.remove(panel->hitItem);
+        panel->hitItem = DOCK_NULL;
 
-        if (left)
-        {
-            ctx->pushRect();
-            ctx->rect.z = splitPos - ctx->theme->panel_margin * 0.5f;
-            if (ctx->rect.Contains(ctx->mouse))
-            {
-                dock_ctx->right_most = false;
-                left->dock(ctx, dock_ctx);
-            }
-            ctx->popRect();
-        }
+        // panel might be a reference to the tab we are erasing, don't use it past this point
+        auto &zone = zones[location.zone];
+        auto index = location.index;
+        zone.panels.erase(zone.panels.begin() + index);
+        reindexZone(location.zone, index);
+        if (zone.active_panel > index || zone.active_panel >= (int)zone.panels.size()) zone.active_panel = std::max(0, zone.active_panel - 1);
+        ++zone.version;
 
-        if (right)
-        {
-            ctx->pushRect();
-            ctx->rect.x += splitPos + ctx->theme->panel_margin * 0.5f;
-            ctx->rect.z -= splitPos + ctx->theme->panel_margin * 0.5f;
-            if (ctx->rect.Contains(ctx->mouse))
-            {
-                dock_ctx->left_most = false;
-                right->dock(ctx, dock_ctx);
-            }
-            ctx->popRect();
-        }
-#endif
+        if (zone.panels.empty() && !zone.keep_around) emptied_zones.push_back(zone.node);
     }
 
-    void DockVSplit::dock(Context* ctx, DockContext* dock_ctx)
+    void PanelsManager::dockPanel(const PanelRef& panel, const DockContext& dock_ctx)
     {
-#if 0
-        // Load of repeated code...
-        float splitPos = (float)(int)amount;
-        if (magnet == eDockMagnet::Bottom) splitPos = (float)(int)(ctx->rect.w - amount);
-        else if (magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.w * amount);
+        auto target = dock_ctx.target;
+        if (!panel || target == DOCK_NULL || nodes[target].type != eDockNodeType::Zone) return;
+
+        // A panel is only ever docked once. Its old zone stays in the tree until the next clean, so target is still valid.
+        undockPanel(panel);
+        panel->hitItem = hit_grid.insert(eHitType::Tab, (uintptr_t)panel.get(), { 0.0f, 0.0f, 0.0f, 0.0f }); // Placed by layout
 
-        if (top)
+        switch (dock_ctx.position)
         {
-            ctx->pushRect();
-            ctx->rect.w = splitPos - ctx->theme->panel_margin * 0.5f;
-            if (ctx->rect.Contains(ctx->mouse))
+            case eDockPanelPosition::Center:
             {
-                dock_ctx->bottom_most = false;
-                top->dock(ctx, dock_ctx);
+                auto &zone = getZone(target);
+                zone.panels.push_back(panel);
+                zone.active_panel = (int)zone.panels.size() - 1;
+                ++zone.version;
+                panel_index[panel.get()] = { nodes[target].zone, zone.active_panel };
+                return;
             }
-            ctx->popRect();
-        }
-
-        if (bottom)
-        {
-            ctx->pushRect();
-            ctx->rect.y += splitPos + ctx->theme->panel_margin * 0.5f;
-            ctx->rect.w -= splitPos + ctx->theme->panel_margin * 0.5f;
-            if (ctx->rect.Contains(ctx->mouse))
+            case eDockPanelPosition::Tab:
             {
-                dock_ctx->top_most = false;
-                bottom->dock(ctx, dock_ctx);
+                auto &zone = getZone(target);
+                auto tabIndex = std::max(0, std::min(dock_ctx.tab_index, (int)zone.panels.size()));
+                zone.panels.insert(zone.panels.begin() + tabIndex, panel);
+                zone.active_panel = tabIndex;
+                ++zone.version;
+                reindexZone(nodes[target].zone, tabIndex);
+                return;
             }
-            ctx->popRect();
+            default:
+                break;
         }
-#endif
-    }
 
-    void DockHSplit::render(Context* ctx)
-    {
-#if 0
-        float splitPos = (float)(int)amount;
-        if (magnet == eDockMagnet::Right) splitPos = (float)(int)(ctx->rect.z - amount);
-        else if (magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.z * amount);
-
-        ctx->pushRect();
-        ctx->rect = Rect(ctx->rect.x + splitPos - ctx->theme->panel_margin * 0.5f, 
-                         ctx->rect.y,
-                         ctx->theme->panel_margin,
-                         ctx->rect.w);
-        auto ui_state = ctx->drawHSplitHandle();
-        ctx->popRect();
-
-        if (left)
-        {
-            ctx->pushRect();
-            ctx->rect.z = splitPos - ctx->theme->panel_margin * 0.5f;
-            left->render(ctx);
-            ctx->popRect();
-        }
+        // An empty zone that was the root could not be cleaned, it can once it has a sibling
+        const auto &targetZone = getZone(target);
+        if (targetZone.panels.empty() && !targetZone.keep_around) emptied_zones.push_back(target);
 
-        if (right)
-        {
-            ctx->pushRect();
-            ctx->rect.x += splitPos + ctx->theme->panel_margin * 0.5f;
-            ctx->rect.z -= splitPos + ctx->theme->panel_margin * 0.5f;
-            right->render(ctx);
-            ctx->popRect();
-        }
-    
-        if (ui_state == eUIState::Drag || ui_state == eUIState::Drop)
-        {
-            g_panels_mgr->dragging_split = OThis;
-            g_panels_mgr->dropped_split = ui_state == eUIState::Drop;
-            g_panels_mgr->dragging_split_rect = ctx->rect;
-        }
-#endif
-    }
+        // Split the target. Its place in the tree is taken by the split, holding the target and a new zone.
+        auto isHorizontal = dock_ctx.position == eDockPanelPosition::Left || dock_ctx.position == eDockPanelPosition::Right;
+        auto isNewFirst = dock_ctx.position == eDockPanelPosition::Left || dock_ctx.position == eDockPanelPosition::Top;
 
-    void DockVSplit::render(Context* ctx)
-    {
-#if 0
-        float splitPos = (float)(int)amount;
-        if (magnet == eDockMagnet::Bottom) splitPos = (float)(int)(ctx->rect.w - amount);
-        else if (magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.w * amount);
-        
-        ctx->pushRect();
-        ctx->rect = Rect(ctx->rect.x, 
-                         ctx->rect.y + splitPos - ctx->theme->panel_margin * 0.5f,
-                         ctx->rect.z,
-                         ctx->theme->panel_margin);
-        auto ui_state = ctx->drawVSplitHandle();
-        ctx->popRect();
-
-        if (top)
-        {
-            ctx->pushRect();
-            ctx->rect.w = splitPos - ctx->theme->panel_margin * 0.5f;
-            top->render(ctx);
-            ctx->popRect();
-        }
+        auto split = allocNode(isHorizontal ? eDockNodeType::HSplit : eDockNodeType::VSplit);
+        auto newZone = allocNode(eDockNodeType::Zone);
+        getZone(newZone).panels.push_back(panel);
+        panel_index[panel.get()] = { nodes[newZone].zone, 0 };
 
-        if (bottom)
-        {
-            ctx->pushRect();
-            ctx->rect.y += splitPos + ctx->theme->panel_margin * 0.5f;
-            ctx->rect.w -= splitPos + ctx->theme->panel_margin * 0.5f;
-            bottom->render(ctx);
-            ctx->popRect();
-        }
-    
-        if (ui_state == eUIState::Drag || ui_state == eUIState::Drop)
-        {
-            g_panels_mgr->dragging_split = OThis;
-            g_panels_mgr->dragging_split_rect = ctx->rect;
-            g_panels_mgr->dropped_split = ui_state == eUIState::Drop;
-        }
-#endif
+        auto parent = nodes[target].parent;
+        if (parent == DOCK_NULL) dock_root = split;
+        else if (nodes[parent].children[0] == target) nodes[parent].children[0] = split;
+        else nodes[parent].children[1] = split;
+
+        auto &splitNode = nodes[split];
+        splitNode.parent = parent;
+        splitNode.amount = dock_ctx.amount;
+        splitNode.magnet = dock_ctx.magnet;
+        splitNode.children[0] = isNewFirst ? newZone : target;
+        splitNode.children[1] = isNewFirst ? target : newZone;
+        nodes[target].parent = split;
+        nodes[newZone].parent = split;
     }
-    
-    void DockZone::undockPanel(const PanelRef& panel)
+
+    void PanelsManager::cleanDock()
     {
-        for (int i = 0, len = (int)panels.size(); i < len; ++i)
+        OGUI_TRACE_ZONE("PanelsManager::cleanDock");
+
+        // Remove empty zones, except the ones kept around. Only zones emptied since the last clean are candidates.
+        // They may have been freed or reused since, so check them again.
+        for (auto node : emptied_zones)
         {
-            if (panels[i] == panel)
-            {
-                panels[i] = nullptr;
-                return;
-            }
+            if (nodes[node].type != eDockNodeType::Zone || node == dock_root) continue;
+
+            const auto &zone = getZone(node);
+            if (zone.panels.empty() && !zone.keep_around) removeZone(node);
         }
+        emptied_zones.clear();
     }
 
-    void DockHSplit::undockPanel(const PanelRef& panel)
+    uint32_t PanelsManager::find(const Panel* panel, int* index) const
     {
-        if (left) left->undockPanel(panel);
-        if (right) right->undockPanel(panel);
-    }
+        auto it = panel_index.find(panel);
+        if (it == panel_index.end()) return DOCK_NULL;
 
-    void DockVSplit::undockPanel(const PanelRef& panel)
-    {
-        if (top) top->undockPanel(panel);
-        if (bottom) bottom->undockPanel(panel);
+        *index = it->second.index;
+        return zones[it->second.zone].node;
     }
-    
-    DockNodeRef DockZone::dockPanel(const PanelRef& panel, const DockContext& dock_ctx)
+
+    void PanelsManager::dock(Context* ctx, DockContext* dock_ctx)
     {
-        if (dock_ctx.target.get() == this)
+        OGUI_TRACE_ZONE("PanelsManager::dock");
+
+        // The zone under the mouse, then up to the root. Splits we go through tell which edges of the screen it touches.
+        auto pHit = hitTest((float)ctx->mouseX, (float)ctx->mouseY);
+        if (!pHit) return;
+
+        int index;
+        auto node = DOCK_NULL;
+        if (pHit->type == eHitType::Zone) node = (uint32_t)pHit->data;
+        else if (pHit->type == eHitType::Tab) node = find((const Panel*)pHit->data, &index);
+        if (node == DOCK_NULL) return; // On a split handle, between two zones
+
+        for (auto child = node, parent = nodes[node].parent; parent != DOCK_NULL; child = parent, parent = nodes[parent].parent)
         {
-            switch (dock_ctx.position)
+            const auto &split = nodes[parent];
+            auto isHorizontal = split.type == eDockNodeType::HSplit;
+            if (split.children[0] == child)
             {
-                case eDockPanelPosition::Center:
-                    panels.push_back(panel);
-                    active_panel = (int)panels.size() - 1;
-                    break;
-                case eDockPanelPosition::Tab:
-                    panels.insert(panels.begin() + dock_ctx.tab_index, panel);
-                    active_panel = dock_ctx.tab_index;
-                    break;
-                case eDockPanelPosition::Left:
-                    return std::make_shared<DockHSplit>(std::make_shared<DockZone>(std::vector<PanelRef>{panel}, 0), shared_from_this(), dock_ctx.amount, dock_ctx.magnet);
-                case eDockPanelPosition::Right:
-                    return std::make_shared<DockHSplit>(shared_from_this(), std::make_shared<DockZone>(std::vector<PanelRef>{panel}, 0), dock_ctx.amount, dock_ctx.magnet);
-                case eDockPanelPosition::Top:
-                    return std::make_shared<DockVSplit>(std::make_shared<DockZone>(std::vector<PanelRef>{panel}, 0), shared_from_this(), dock_ctx.amount, dock_ctx.magnet);
-                case eDockPanelPosition::Bottom:
-                    return std::make_shared<DockVSplit>(shared_from_this(), std::make_shared<DockZone>(std::vector<PanelRef>{panel}, 0), dock_ctx.amount, dock_ctx.magnet);
+                if (isHorizontal) dock_ctx->right_most = false;
+                else dock_ctx->bottom_most = false;
+            }
+            else
+            {
+                if (isHorizontal) dock_ctx->left_most = false;
+                else dock_ctx->top_most = false;
             }
         }
 
-        return shared_from_this();
+        dock_ctx->target = node;
+        dock_ctx->position = eDockPanelPosition::Center;
     }
 
-    DockNodeRef DockHSplit::dockPanel(const PanelRef& panel, const DockContext& dock_ctx)
+    void PanelsManager::updateZoneLayout(DockZone& zone, const Rect& parentRect, Context* ctx)
     {
-        if (left)
-        {
-            auto new_node = left->dockPanel(panel, dock_ctx);
-            if (new_node != left) left = new_node;
-        }
-        if (right)
-        {
-            auto new_node = right->dockPanel(panel, dock_ctx);
-            if (new_node != right) right = new_node;
-        }
-        return shared_from_this();
-    }
+        ++zone.version;
+        hit_grid.update(nodes[zone.node].hit_item, parentRect);
 
-    DockNodeRef DockVSplit::dockPanel(const PanelRef& panel, const DockContext& dock_ctx)
-    {
-        if (top)
+        auto pFont = ctx->getFont(ctx->theme.font, ctx->theme.fontSize);
+        float tabOffset = 0.0f;
+        for (int i = 0, len = (int)zone.panels.size(); i < len; ++i)
         {
-            auto new_node = top->dockPanel(panel, dock_ctx);
-            if (new_node != top) top = new_node;
-        }
-        if (bottom)
-        {
-            auto new_node = bottom->dockPanel(panel, dock_ctx);
-            if (new_node != bottom) bottom = new_node;
-        }
-        return shared_from_this();
-    }
+            const auto &pPanel = zone.panels[i];
 
-    DockZoneRef DockZone::find(const PanelRef& panel, int* index)
-    {
-        for (int i = 0; i < (int)panels.size(); ++i)
-        {
-            if (panels[i] == panel)
-            {
-                *index = i;
-                return shared_from_this();
-            }
-        }
+            auto clientRect = parentRect;
+            clientRect.y += ctx->theme.controlHeight;
+            clientRect.h -= ctx->theme.controlHeight;
+            pPanel->updateLayout(clientRect);
 
-        return nullptr;
-    }
+            auto tabRect = parentRect;
+            tabRect.x += tabOffset;
+            tabRect.h = ctx->theme.controlHeight;
+            auto textSize = pFont->measure(pPanel->title);
+            tabRect.w = (float)(int)(textSize + ctx->theme.tabPadding * 2.0f);
+            if (pPanel->hasCloseButton) tabRect.w += ctx->theme.toolButtonSize + ctx->theme.tabPadding;
+            pPanel->tabRect = tabRect;
 
-    DockZoneRef DockHSplit::find(const PanelRef& panel, int* index)
-    {
-        if (left)  if (auto ret = left->find(panel, index))  return ret;
-        if (right) if (auto ret = right->find(panel, index)) return ret;
-        return nullptr;
-    }
+            // Only the part of the tab inside the zone can be clicked
+            auto tabRight = std::min(tabRect.x + tabRect.w, parentRect.x + parentRect.w);
+            auto tabBottom = std::min(tabRect.y + tabRect.h, parentRect.y + parentRect.h);
+            hit_grid.update(pPanel->hitItem, { tabRect.x, tabRect.y, std::max(0.0f, tabRight - tabRect.x), std::max(0.0f, tabBottom - tabRect.y) });
 
-    DockZoneRef DockVSplit::find(const PanelRef& panel, int* index)
-    {
-        if (top)    if (auto ret = top->find(panel, index))    return ret;
-        if (bottom) if (auto ret = bottom->find(panel, index)) return ret;
-        return nullptr;
+            tabOffset += tabRect.w + ctx->theme.tabSpacing;
+        }
     }
 
-    DockNodeRef DockKeepAround::clean()
+    void PanelsManager::updateLayout(Context* ctx)
     {
-        DockZone::clean();
-        return nullptr;
-    }
+        OGUI_TRACE_ZONE("PanelsManager::updateLayout");
 
-    DockNodeRef DockZone::clean()
-    {
-        for (auto it = panels.begin(); it != panels.end();)
+        nodes[dock_root].rect = ctx->getRect();
+        hit_grid.resize(nodes[dock_root].rect.w, nodes[dock_root].rect.h);
+        stack.clear();
+        stack.push_back(dock_root);
+        while (!stack.empty())
         {
-            if (*it == nullptr)
+            auto &node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.type == eDockNodeType::Zone)
             {
-                it = panels.erase(it);
+                updateZoneLayout(zones[node.zone], node.rect, ctx);
                 continue;
             }
-            ++it;
-        }
-        if (panels.empty()) return std::make_shared<DockNull>();
 
-        active_panel = std::min(active_panel, (int)panels.size() - 1);
-        return nullptr;
-    }
-
-    DockNodeRef DockHSplit::clean()
-    {
-        if (left)
-        {
-            auto new_node = left->clean();
-            if (new_node) left = new_node;
-            if (std::dynamic_pointer_cast<DockNull>(left)) left = nullptr;
-        }
+            const auto &parentRect = node.rect;
+            auto &first = nodes[node.children[0]];
+            auto &second = nodes[node.children[1]];
+            switch (node.type)
+            {
+                case eDockNodeType::HSplit:
+                {
+                    float splitPos = (float)(int)node.amount;
+                    if (node.magnet == eDockMagnet::Right) splitPos = (float)(int)(parentRect.w - node.amount);
+                    else if (node.magnet == eDockMagnet::Middle) splitPos = (float)(int)(parentRect.w * node.amount);
 
-        if (right)
-        {
-            auto new_node = right->clean();
-            if (new_node) right = new_node;
-            if (std::dynamic_pointer_cast<DockNull>(right)) right = nullptr;
-        }
+                    first.rect = parentRect;
+                    first.rect.w = splitPos - ctx->theme.panelMargin * 0.5f;
 
-        if (!left && !right) return std::make_shared<DockNull>();
-        if (!left) return right;
-        if (!right) return left;
+                    second.rect = parentRect;
+                    second.rect.x += splitPos + ctx->theme.panelMargin * 0.5f;
+                    second.rect.w -= splitPos + ctx->theme.panelMargin * 0.5f;
+                    hit_grid.update(node.hit_item, { first.rect.x + first.rect.w, parentRect.y, second.rect.x - first.rect.x - first.rect.w, parentRect.h });
+                    break;
+                }
+                case eDockNodeType::VSplit:
+                {
+                    float splitPos = (float)(int)node.amount;
+                    if (node.magnet == eDockMagnet::Bottom) splitPos = (float)(int)(parentRect.h - node.amount);
+                    else if (node.magnet == eDockMagnet::Middle) splitPos = (float)(int)(parentRect.h * node.amount);
 
-        return nullptr;
-    }
+                    first.rect = parentRect;
+                    first.rect.h = splitPos - ctx->theme.panelMargin * 0.5f;
 
-    DockNodeRef DockVSplit::clean()
-    {
-        if (top)
-        {
-            auto new_node = top->clean();
-            if (new_node) top = new_node;
-            if (std::dynamic_pointer_cast<DockNull>(top)) top = nullptr;
-        }
+                    second.rect = parentRect;
+                    second.rect.y += splitPos + ctx->theme.panelMargin * 0.5f;
+                    second.rect.h -= splitPos + ctx->theme.panelMargin * 0.5f;
+                    hit_grid.update(node.hit_item, { parentRect.x, first.rect.y + first.rect.h, parentRect.w, second.rect.y - first.rect.y - first.rect.h });
+                    break;
+                }
+                default:
+                    continue;
+            }
 
-        if (bottom)
-        {
-            auto new_node = bottom->clean();
-            if (new_node) bottom = new_node;
-            if (std::dynamic_pointer_cast<DockNull>(bottom)) bottom = nullptr;
+            stack.push_back(node.children[1]);
+            stack.push_back(node.children[0]);
         }
-
-        if (!top && !bottom) return std::make_shared<DockNull>();
-        if (!top) return bottom;
-        if (!bottom) return top;
-
-        return nullptr;
     }
 
-    PanelsManager::PanelsManager()
+    void PanelsManager::updateLayout(const Panel* panel, Context* ctx)
     {
-        // We only start with document's view
-        document_zone = std::make_shared<DockKeepAround>("Documents View", std::vector<PanelRef>{}, 0);
-        dock_root = document_zone;
+        int index;
+        auto node = find(panel, &index);
+        if (node == DOCK_NULL) return;
+
+        const auto &rect = nodes[node].rect;
+        updateZoneLayout(getZone(node), rect, ctx);
+        ctx->setDirty(rect);
     }
 
-    PanelsManager::~PanelsManager()
+    Panel *PanelsManager::activePanelAt(float x, float y) const
     {
+        auto pHit = hitTest(x, y);
+        if (!pHit) return nullptr;
+
+        int index;
+        auto node = DOCK_NULL;
+        if (pHit->type == eHitType::Zone) node = (uint32_t)pHit->data;
+        else if (pHit->type == eHitType::Tab) node = find((const Panel*)pHit->data, &index);
+        if (node == DOCK_NULL) return nullptr;
+
+        const auto &zone = getZone(node);
+        if (zone.panels.empty()) return nullptr;
+        return zone.panels[zone.active_panel].get();
     }
 
-    void PanelsManager::undockPanel(const PanelRef& panel)
+    void PanelsManager::activatePanel(const Panel* panel, Context* ctx)
     {
-        dock_root->undockPanel(panel);
+        int index;
+        auto node = find(panel, &index);
+        if (node == DOCK_NULL) return;
+
+        auto &zone = getZone(node);
+        if (zone.active_panel == index) return;
+        zone.active_panel = index;
+        ++zone.version;
+        ctx->setDirty(nodes[node].rect);
     }
 
-    void PanelsManager::dockPanel(const PanelRef& panel, const DockContext& dock_ctx)
+    void PanelsManager::dragSplit(float x, float y, Context* ctx)
     {
-        auto new_root = dock_root->dockPanel(panel, dock_ctx);
-        if (new_root != dock_root) dock_root = new_root;
+        if (dragging_split == DOCK_NULL) return;
+
+        // Keep both sides at least their minimum size, when there is room for it
+        auto &split = nodes[dragging_split];
+        if (split.type != eDockNodeType::HSplit && split.type != eDockNodeType::VSplit) return; // Cleaned while dragging
+        const auto &rect = split.rect;
+        auto isHorizontal = split.type == eDockNodeType::HSplit;
+        auto size = isHorizontal ? rect.w : rect.h;
+        auto minSize = std::min(isHorizontal ? ctx->theme.minHSize : ctx->theme.minVSize, size * 0.5f);
+        auto splitPos = std::max(minSize, std::min(size - minSize, isHorizontal ? x - rect.x : y - rect.y));
+
+        if (split.magnet == eDockMagnet::Middle) split.amount = size > 0.0f ? splitPos / size : 0.5f;
+        else if (split.magnet == eDockMagnet::Left) split.amount = splitPos; // Also Top
+        else split.amount = size - splitPos;
     }
 
-    void PanelsManager::cleanDock()
+    void PanelsManager::renderZone(DockZone& zone, const Rect& rect, Context* ctx)
     {
-        auto new_root = dock_root->clean();
-        if (new_root) dock_root = new_root;
-        if (std::dynamic_pointer_cast<DockNull>(dock_root))
+        OGUI_TRACE_ZONE("PanelsManager::renderZone");
+        const auto &panels = zone.panels;
+        if (panels.empty()) return;
+        if (!ctx->isDamaged(rect)) return;
+
+        // Only re-tessellate if something changed in the zone or its panels
+        auto &cache = zone.cache;
+        auto currentVersion = zone.getVersion();
+        if (cache.version != currentVersion)
         {
-            dock_root = std::make_shared<DockZone>(std::vector<PanelRef>{}, 0); // Empty screen
+            ctx->beginCache(cache);
+
+            // Active panel
+            const auto &pActivePanel = panels[zone.active_panel];
+            ctx->drawRect(pActivePanel->clientRect, ctx->theme.panelColor);
+
+            // Tabs
+            auto pFont = ctx->getFont(ctx->theme.font, ctx->theme.fontSize);
+            for (int i = 0, len = (int)panels.size(); i < len; ++i)
+            {
+                const auto &pPanel = panels[i];
+                if (pPanel->tabRect.x >= rect.x + rect.w) break;
+                const auto &tabRect = pPanel->tabRect;
+                ctx->drawRect(tabRect, i == zone.active_panel ? ctx->theme.panelColor : ctx->theme.inactiveTabColor);
+                ctx->drawText(*pFont, pPanel->title, { tabRect.x + ctx->theme.tabPadding, tabRect.y + (tabRect.h - pFont->size) * 0.5f }, ctx->theme.textColor);
+
+                if (pPanel->hasCloseButton)
+                {
+                    if (auto pCloseIcon = ctx->pAtlas->getImage(ctx->theme.xIcon))
+                    {
+                        auto size = ctx->theme.toolButtonSize;
+                        ctx->drawImage({ tabRect.x + tabRect.w - ctx->theme.tabPadding - size, tabRect.y + (tabRect.h - size) * 0.5f, size, size }, *pCloseIcon, ctx->theme.toolButtonColor);
+                    }
+                }
+            }
+
+            ctx->endCache(cache);
+            cache.version = currentVersion;
         }
-    }
 
-    DockZoneRef PanelsManager::find(const PanelRef& panel, int* index)
-    {
-        return dock_root->find(panel, index);
-    }
+        ctx->drawCache(cache);
 
-    void PanelsManager::updateLayout(Context* ctx)
-    {
-        dock_root->updateLayout(ctx->getRect(), ctx);
+        // Widgets aren't cached, big lists only generate the rows in view
+        panels[zone.active_panel]->renderWidgets();
     }
 
     void PanelsManager::render(Context* ctx)
     {
-#if 0
-        // Draw UIs
-        dragging_panel  = nullptr;
-        dragging_split  = nullptr;
-        dropped_panel   = false;
-        closed_panel    = false;
-
-        ctx->begin();
-        dock_root->render(ctx);
-
-        // Draw/Do docking
-        if (dragging_panel)
-        {
-            DockContext dock_context;
-            dock_context.target         = nullptr;
-            dock_context.left_most      = true;
-            dock_context.right_most     = true;
-            dock_context.top_most       = true;
-            dock_context.bottom_most    = true;
+        OGUI_TRACE_ZONE("PanelsManager::render");
 
-            dock_root->dock(ctx, &dock_context);
+        // Zones to draw. Depth first, first child before second, like the recursive version did.
+        // Both live in the frame arena, reserved once for the whole tree.
+        ArenaVector<uint32_t> render_zones(ArenaAllocator<uint32_t>(ctx->pFrameArena));
+        ArenaVector<uint32_t> render_stack(ArenaAllocator<uint32_t>(ctx->pFrameArena));
+        render_zones.reserve(zones.size());
+        render_stack.reserve(nodes.size());
+        render_stack.push_back(dock_root);
+        while (!render_stack.empty())
+        {
+            auto &node = nodes[render_stack.back()];
+            render_stack.pop_back();
 
-            if (dock_context.target && dropped_panel)
+            switch (node.type)
             {
-                undockPanel(dragging_panel);
-                dockPanel(dragging_panel, dock_context);
-                cleanDock();
+                case eDockNodeType::Zone:
+                    if (!zones[node.zone].panels.empty() && ctx->isDamaged(node.rect)) render_zones.push_back(node.zone);
+                    continue;
+                case eDockNodeType::HSplit:
+                case eDockNodeType::VSplit:
+                    break;
+                case eDockNodeType::Free:
+                    continue;
             }
+
+            render_stack.push_back(node.children[1]);
+            render_stack.push_back(node.children[0]);
         }
 
-        // Draw/Do split dragging
-        if (dragging_split)
+        // Widgets are laid out before anything is drawn, the same way whether zones are generated in parallel or not
+        for (auto zone : render_zones)
         {
-            auto hsplit = ODynamicCast<DockHSplit>(dragging_split);
-            auto vsplit = ODynamicCast<DockVSplit>(dragging_split);
+            const auto &pPanel = zones[zone].panels[zones[zone].active_panel];
+            if (pPanel->isWidgetLayoutNeeded() && !pPanel->widgets.empty()) pPanel->layoutWidgets();
+        }
 
-            if (hsplit)
-            {
-                float splitPos = (float)(int)hsplit->amount;
-                if (hsplit->magnet == eDockMagnet::Right) splitPos = (float)(int)(ctx->rect.z - hsplit->amount);
-                else if (hsplit->magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.z * hsplit->amount);
-
-                splitPos = (ctx->mouse.x - dragging_split_rect.x);
-                splitPos = std::max(splitPos, ctx->theme->min_h_size);
-                splitPos = std::min(splitPos, dragging_split_rect.z - ctx->theme->min_h_size);
-
-                ctx->drawRect(nullptr, Rect(
-                    dragging_split_rect.x + splitPos - ctx->theme->panel_padding * 0.5f,
-                    dragging_split_rect.y,
-                    ctx->theme->panel_padding,
-                    dragging_split_rect.w),
-                    ctx->theme->dock_color);
-
-                if (dropped_split)
-                {
-                    if (hsplit->magnet == eDockMagnet::Left) hsplit->amount = splitPos;
-                    else if (hsplit->magnet == eDockMagnet::Right) hsplit->amount = dragging_split_rect.z - splitPos;
-                    else if (hsplit->magnet == eDockMagnet::Middle) hsplit->amount = splitPos / dragging_split_rect.z;
-                }
-            }
-            else if (vsplit) // Implied
+        if (!ctx->pJobPool || render_zones.size() < 2)
+        {
+            for (auto zone : render_zones)
             {
-                float splitPos = (float)(int)vsplit->amount;
-                if (vsplit->magnet == eDockMagnet::Bottom) splitPos = (float)(int)(ctx->rect.w - vsplit->amount);
-                else if (vsplit->magnet == eDockMagnet::Middle) splitPos = (float)(int)(ctx->rect.w * vsplit->amount);
-
-                splitPos = (ctx->mouse.y - dragging_split_rect.y);
-                splitPos = std::max(splitPos, ctx->theme->min_v_size);
-                splitPos = std::min(splitPos, dragging_split_rect.w - ctx->theme->min_v_size);
-
-                ctx->drawRect(nullptr, Rect(
-                    dragging_split_rect.x,
-                    dragging_split_rect.y + splitPos - ctx->theme->panel_padding * 0.5f,
-                    dragging_split_rect.z,
-                    ctx->theme->panel_padding),
-                    ctx->theme->dock_color);
-
-                if (dropped_split)
-                {
-                    if (vsplit->magnet == eDockMagnet::Top) vsplit->amount = splitPos;
-                    else if (vsplit->magnet == eDockMagnet::Bottom) vsplit->amount = dragging_split_rect.w - splitPos;
-                    else if (vsplit->magnet == eDockMagnet::Middle) vsplit->amount = splitPos / dragging_split_rect.w;
-                }
+                ctx->flush(); // Like appending a zone's target does
+                renderZone(zones[zone], nodes[zones[zone].node].rect, ctx);
             }
+            return;
         }
 
-        if (closed_panel)
+        // Zones don't overlap. Each one is generated into its own target, fonts and the atlas are only read.
+        if (zone_targets.size() < render_zones.size()) zone_targets.resize(render_zones.size());
+        // Two captures fit in std::function without allocating, the manager is reached through ctx
+        ctx->pJobPool->run((uint32_t)render_zones.size(), [ctx, &render_zones](uint32_t job)
         {
-            cleanDock();
-        }
+            auto pManager = ctx->pPanelsManager;
+            auto &zone = pManager->zones[render_zones[job]];
+            ctx->beginTarget(pManager->zone_targets[job], true);
+            pManager->renderZone(zone, pManager->nodes[zone.node].rect, ctx);
+            ctx->endTarget(pManager->zone_targets[job]);
+        });
 
-        // Submit draw
-        ctx->end();
-#endif
+        // Zones that needed a glyph or an image not loaded yet are generated again, in dock order, so things get loaded
+        // in the same order as on one thread
+        for (size_t job = 0; job < render_zones.size(); ++job)
+        {
+            auto &target = zone_targets[job];
+            if (target.isIncomplete)
+            {
+                auto &zone = zones[render_zones[job]];
+                zone.cache.version = ~0ull; // May hold what was generated without them
+                ctx->beginTarget(target, false);
+                renderZone(zone, nodes[zone.node].rect, ctx);
+                ctx->endTarget(target);
+            }
+            ctx->appendTarget(target);
+        }
     }
 }
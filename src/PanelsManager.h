@@ -1,12 +1,16 @@
 #pragma once
 
+#include "Context.h"
+#include "HitGrid.h"
 #include "ogui/types.h"
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace ogui
 {
-    enum class eDockMagnet
+    enum class eDockMagnet : uint8_t
     {
         Left    = 0,
         Top     = 0,
@@ -25,113 +29,58 @@ namespace ogui
         Tab
     };
 
-    struct DockContext;
-
-    class DockNode;
-    using DockNodeRef = std::shared_ptr<DockNode>;
+    enum class eDockNodeType : uint8_t
+    {
+        Free,   // In the free list
+        Zone,
+        HSplit,
+        VSplit
+    };
 
-    class DockZone;
-    using DockZoneRef = std::shared_ptr<DockZone>;
+    static const uint32_t DOCK_NULL = 0xFFFFFFFF;
 
     class Context;
 
     class Panel;
     using PanelRef = std::shared_ptr<Panel>;
-    
-    class DockNode
-    {
-    public:
-        virtual void render(Context* ctx) = 0;
-        virtual void updateLayout(const Rect &parentRect, Context* ctx) = 0;
-        virtual void dock(Context* ctx, DockContext* dock_ctx) = 0;
-        virtual void undockPanel(const PanelRef& panel) = 0;
-        virtual DockNodeRef clean() = 0;
-        virtual DockNodeRef dockPanel(const PanelRef& panel, const DockContext& dock_ctx) = 0;
-        virtual DockZoneRef find(const PanelRef& panel, int* index) = 0;
-    };
 
-    class DockNull final : public DockNode
+    // Node of the dock tree. Nodes live in PanelsManager::nodes and reference each other by index.
+    struct DockNode
     {
-    public:
-        void render(Context* ctx) override {};
-        void updateLayout(const Rect &parentRect, Context* ctx) override {};
-        void dock(Context* ctx, DockContext* dock_ctx) override {};
-        void undockPanel(const PanelRef& panel) override {};
-        DockNodeRef clean() override { return nullptr; };
-        DockNodeRef dockPanel(const PanelRef& panel, const DockContext& dock_ctx) override { return nullptr; };
-        DockZoneRef find(const PanelRef& panel, int* index) override { return nullptr; }
+        eDockNodeType   type        = eDockNodeType::Free;
+        eDockMagnet     magnet      = eDockMagnet::Middle;  // Splits only
+        float           amount      = 0.0f;                 // Splits only. In pixels from the magnet side, or a ratio when magnet is Middle.
+        uint32_t        parent      = DOCK_NULL;
+        uint32_t        children[2] = { DOCK_NULL, DOCK_NULL }; // Left/Top then Right/Bottom. Free nodes use children[0] as the next free node.
+        uint32_t        zone        = DOCK_NULL;            // Zones only. Index in PanelsManager::zones.
+        uint32_t        hit_item    = DOCK_NULL;            // In PanelsManager::hit_grid. The zone's rect, or the split's handle.
+        Rect            rect        = { 0.0f, 0.0f, 0.0f, 0.0f };
     };
 
-    // Dock zone is a leaf node. Containing one or many panels with tabs
-    class DockZone : public DockNode, public std::enable_shared_from_this<DockZone>
+    // Leaf of the dock tree. Containing one or many panels with tabs
+    struct DockZone
     {
-    public:
         std::vector<PanelRef>   panels;
         int                     active_panel = 0;
+        uint32_t                version = 0;
+        uint32_t                node = DOCK_NULL;   // DOCK_NULL when the zone is free
+        bool                    keep_around = false; // Stays in the tree when empty, like the documents view
+        std::string             text;               // Shown when a keep around zone is empty
+        DrawCache               cache;
 
-        DockZone(const std::vector<PanelRef>& panels, int active_panel);
-
-        void render(Context* ctx) override;
-        void updateLayout(const Rect &parentRect, Context* ctx) override;
-        void dock(Context* ctx, DockContext* dock_ctx) override;
-        void undockPanel(const PanelRef& panel) override;
-        DockNodeRef clean() override;
-        DockNodeRef dockPanel(const PanelRef& panel, const DockContext& dock_ctx) override;
-        DockZoneRef find(const PanelRef& panel, int* index) override;
+        uint64_t getVersion() const;
     };
 
-    class DockKeepAround final : public DockZone
+    // Where a docked panel is. Kept in PanelsManager::panel_index.
+    struct DockLocation
     {
-    public:
-        std::string text;
-
-        DockKeepAround(const std::string& text, const std::vector<PanelRef>& panels, int active_panel);
-
-        void render(Context* ctx) override;
-        DockNodeRef clean() override;
-    };
-
-    class DockHSplit final : public DockNode, public std::enable_shared_from_this<DockHSplit>
-    {
-    public:
-        DockNodeRef left;
-        DockNodeRef right;
-        float       amount = 300.0f;
-        eDockMagnet magnet = eDockMagnet::Left;
-
-        DockHSplit(DockNodeRef left, DockNodeRef right, float amount, eDockMagnet magnet);
-
-        void render(Context* ctx) override;
-        void updateLayout(const Rect &parentRect, Context* ctx) override;
-        void dock(Context* ctx, DockContext* dock_ctx) override;
-        void undockPanel(const PanelRef& panel) override;
-        DockNodeRef clean() override;
-        DockNodeRef dockPanel(const PanelRef& panel, const DockContext& dock_ctx) override;
-        DockZoneRef find(const PanelRef& panel, int* index) override;
-    };
-
-    class DockVSplit final : public DockNode, public std::enable_shared_from_this<DockVSplit>
-    {
-    public:
-        DockNodeRef top;
-        DockNodeRef bottom;
-        float       amount = 200.0f;
-        eDockMagnet magnet = eDockMagnet::Bottom;
-
-        DockVSplit(DockNodeRef top, DockNodeRef bottom, float amount, eDockMagnet magnet);
-
-        void render(Context* ctx) override;
-        void updateLayout(const Rect &parentRect, Context* ctx) override;
-        void dock(Context* ctx, DockContext* result) override;
-        void undockPanel(const PanelRef& panel) override;
-        DockNodeRef clean() override;
-        DockNodeRef dockPanel(const PanelRef& panel, const DockContext& dock_ctx) override;
-        DockZoneRef find(const PanelRef& panel, int* index) override;
+        uint32_t    zone    = DOCK_NULL;    // Index in PanelsManager::zones
+        int         index   = 0;            // Tab index in the zone
     };
 
     struct DockContext
     {
-        DockZoneRef         target;
+        uint32_t            target      = DOCK_NULL; // Zone node
         eDockPanelPosition  position    = eDockPanelPosition::Center;
         int                 tab_index   = 0;
         float               amount      = 0.5f;
@@ -142,13 +91,17 @@ namespace ogui
         bool                bottom_most = true;
     };
 
+    // The dock tree is stored flat. Splits and zones are nodes in a contiguous array, traversed iteratively.
+    // Removed nodes and zones go into free lists, so docking and undocking don't allocate in steady state.
     class PanelsManager final
     {
     public:
-        DockNodeRef             dock_root;
+        std::vector<DockNode>   nodes;
+        std::vector<DockZone>   zones;
+        uint32_t                dock_root       = DOCK_NULL;
+        uint32_t                document_zone   = DOCK_NULL; // Zone node of the documents view
         PanelRef                dragging_panel;
-        DockNodeRef             dragging_split;
-        DockZoneRef             document_zone;
+        uint32_t                dragging_split  = DOCK_NULL;
         Rect                    dragging_split_rect;
         bool                    dropped_panel   = false;
         bool                    dropped_split   = false;
@@ -158,11 +111,38 @@ namespace ogui
         ~PanelsManager();
 
         void undockPanel(const PanelRef& panel);
-        void dockPanel(const PanelRef& panel, const DockContext& dock_ctx); 
+        void dockPanel(const PanelRef& panel, const DockContext& dock_ctx);
         void cleanDock();
-        DockZoneRef find(const PanelRef& panel, int* index);
-        
+        uint32_t find(const Panel* panel, int* index) const; // Zone node containing the panel, or DOCK_NULL
+        uint32_t find(const PanelRef& panel, int* index) const { return find(panel.get(), index); }
+        const HitItem *hitTest(float x, float y) const { return hit_grid.query(x, y); }
+        Panel *activePanelAt(float x, float y) const; // Shown in the zone under a point, tabs included
+        void activatePanel(const Panel* panel, Context* ctx);
+        void dragSplit(float x, float y, Context* ctx); // Moves dragging_split's handle to the mouse
+        void dock(Context* ctx, DockContext* dock_ctx);
+
+        DockZone &getZone(uint32_t node) { return zones[nodes[node].zone]; }
+        const DockZone &getZone(uint32_t node) const { return zones[nodes[node].zone]; }
+
         void updateLayout(Context* ctx);
+        void updateLayout(const Panel* panel, Context* ctx); // Only the zone holding the panel
         void render(Context* ctx);
+
+    private:
+        uint32_t allocNode(eDockNodeType type);
+        uint32_t allocZone(uint32_t node);
+        void freeNode(uint32_t node);
+        void removeZone(uint32_t node);
+        void reindexZone(uint32_t zoneIndex, int from);
+        void updateZoneLayout(DockZone& zone, const Rect& rect, Context* ctx);
+        void renderZone(DockZone& zone, const Rect& rect, Context* ctx);
+
+        uint32_t                free_node = DOCK_NULL;
+        std::vector<uint32_t>   free_zones;
+        std::unordered_map<const Panel*, DockLocation> panel_index; // Every docked panel
+        std::vector<uint32_t>   emptied_zones; // Zone nodes emptied since the last cleanDock
+        HitGrid                 hit_grid; // Zones, split handles and tabs. Updated by layout.
+        std::vector<uint32_t>   stack; // Traversal scratch
+        std::vector<DrawTarget> zone_targets; // Of the damaged zones, when generated in parallel. Kept, so their buffers are reused.
     };
 }
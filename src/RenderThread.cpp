@@ -0,0 +1,170 @@
+#include "RenderThread.h"
+#include "ogui/IRenderer.h"
+#include "Trace.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace ogui
+{
+    RenderThread::RenderThread(Context *in_pContext)
+        : pContext(in_pContext)
+    {
+        thread = std::thread([this]() { work(); });
+    }
+
+    RenderThread::~RenderThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            isStopping = true;
+        }
+        wakeCondition.notify_one();
+        thread.join();
+
+        // Textures created since the last frame, and destroyed ones, are still owed to the renderer
+        runTextureOps(textureOpsEnd);
+    }
+
+    void RenderThread::createTexture(Texture &texture)
+    {
+        TextureOp op;
+        op.type = TextureOp::eType::Create;
+        op.pTexture = &texture;
+        op.x = 0;
+        op.y = 0;
+        op.width = texture.width;
+        op.height = texture.height;
+        op.isCreated = false;
+        if (texture.pData) op.pixels.assign(texture.pData, texture.pData + (size_t)texture.width * texture.height * 4);
+        pushTextureOp(op);
+    }
+
+    void RenderThread::updateTexture(Texture &texture)
+    {
+        TextureOp op;
+        op.type = TextureOp::eType::Update;
+        op.pTexture = &texture;
+        op.x = 0;
+        op.y = 0;
+        op.width = texture.width;
+        op.height = texture.height;
+        op.isCreated = true;
+        if (texture.pData) op.pixels.assign(texture.pData, texture.pData + (size_t)texture.width * texture.height * 4);
+        pushTextureOp(op);
+    }
+
+    void RenderThread::updateTextureRegion(Texture &texture, const TextureRegion &region)
+    {
+        TextureOp op;
+        op.type = TextureOp::eType::UpdateRegion;
+        op.pTexture = &texture;
+        op.x = region.x;
+        op.y = region.y;
+        op.width = region.width;
+        op.height = region.height;
+        op.isCreated = true;
+
+        // Only the region's rows
+        auto stride = (size_t)texture.width * 4;
+        auto rowSize = (size_t)region.width * 4;
+        op.pixels.resize(rowSize * region.height);
+        for (uint32_t row = 0; row < region.height; ++row)
+        {
+            memcpy(op.pixels.data() + row * rowSize, texture.pData + (region.y + row) * stride + region.x * 4, rowSize);
+        }
+        pushTextureOp(op);
+    }
+
+    void RenderThread::destroyTexture(Texture *pTexture, bool isCreated)
+    {
+        TextureOp op;
+        op.type = TextureOp::eType::Destroy;
+        op.pTexture = pTexture;
+        op.x = 0;
+        op.y = 0;
+        op.width = 0;
+        op.height = 0;
+        op.isCreated = isCreated;
+        pushTextureOp(op);
+    }
+
+    void RenderThread::pushTextureOp(TextureOp &op)
+    {
+        std::lock_guard<std::mutex> lock(textureOpsMutex);
+        textureOps.push_back(std::move(op));
+        ++textureOpsEnd;
+    }
+
+    bool RenderThread::publish()
+    {
+        packets[back].textureOpsEnd = textureOpsEnd;
+
+        // The render thread can have taken the middle packet or not, either way it comes back as the next back packet
+        auto previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & ~FRESH;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_one();
+        return (previous & FRESH) != 0;
+    }
+
+    void RenderThread::work()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait(lock, [this]() { return isStopping || (middle.load(std::memory_order_acquire) & FRESH); });
+
+                // The last frame is still drawn, the screen would miss it otherwise
+                if (isStopping && !(middle.load(std::memory_order_acquire) & FRESH)) return;
+            }
+
+            OGUI_TRACE_ZONE("RenderThread::submit");
+            front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+            const auto &packet = packets[front];
+            runTextureOps(packet.textureOpsEnd);
+            pContext->submit(packet.vertices, packet.drawList, packet.damageRects, stats, false);
+        }
+    }
+
+    void RenderThread::runTextureOps(uint64_t end)
+    {
+        if (end == textureOpsBegin) return;
+
+        {
+            std::lock_guard<std::mutex> lock(textureOpsMutex);
+            auto count = (size_t)(end - textureOpsBegin);
+            runningOps.clear();
+            std::move(textureOps.begin(), textureOps.begin() + count, std::back_inserter(runningOps));
+            textureOps.erase(textureOps.begin(), textureOps.begin() + count);
+            textureOpsBegin = end;
+        }
+
+        OGUI_TRACE_ZONE("RenderThread::runTextureOps");
+        auto pRenderer = pContext->pRenderer;
+        for (auto &op : runningOps)
+        {
+            auto pPixels = op.pixels.empty() ? nullptr : op.pixels.data();
+            switch (op.type)
+            {
+                case TextureOp::eType::Create:
+                    op.pTexture->id = pRenderer->createTexture(op.width, op.height, pPixels);
+                    break;
+                case TextureOp::eType::Update:
+                    op.pTexture->id = pRenderer->updateTexture(op.pTexture->id, op.width, op.height, pPixels);
+                    break;
+                case TextureOp::eType::UpdateRegion:
+                    pRenderer->updateTextureRegion(op.pTexture->id, op.x, op.y, op.width, op.height, op.width * 4, pPixels);
+                    break;
+                case TextureOp::eType::Destroy:
+                    if (op.isCreated) pRenderer->destroyTexture(op.pTexture->id);
+                    delete op.pTexture;
+                    break;
+            }
+        }
+        runningOps.clear();
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Context.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ogui
+{
+    // A generated frame, everything the render thread needs to submit it
+    struct FramePacket
+    {
+        std::vector<Vertex> vertices;
+        std::vector<DrawCommand> drawList;
+        std::vector<Rect> damageRects;
+        uint64_t textureOpsEnd = 0; // Texture ops to run before drawing it
+    };
+
+    // Submits frames to the renderer from a thread of its own, so a slow submit or a vsync wait doesn't hold the UI
+    // thread. Frames are passed through a lock-free triple buffer: the UI thread fills the back packet and swaps it
+    // with the middle one, the render thread swaps its front packet with the middle one when it is newer. A frame the
+    // render thread didn't get to before the next one was published is dropped.
+    // Texture ops can't be dropped, frames need the textures created before them. They are queued in order, and run
+    // on the render thread up to the ops of the frame it draws. Destroyed textures are deleted there too, after every
+    // frame that could bind them.
+    class RenderThread final
+    {
+    public:
+        RenderThread(Context *pContext);
+        ~RenderThread(); // Runs the texture ops left on the calling thread
+
+        // Pixels are copied, the texture's data can change right after
+        void createTexture(Texture &texture);
+        void updateTexture(Texture &texture);
+        void updateTextureRegion(Texture &texture, const TextureRegion &region);
+        void destroyTexture(Texture *pTexture, bool isCreated); // Deletes pTexture
+
+        FramePacket &getBackPacket() { return packets[back]; }
+        bool publish(); // True when the previous frame was dropped
+
+    private:
+        struct TextureOp
+        {
+            enum class eType
+            {
+                Create,
+                Update,
+                UpdateRegion,
+                Destroy
+            };
+
+            eType type;
+            Texture *pTexture;
+            uint32_t x, y, width, height;
+            bool isCreated; // Destroy
+            std::vector<uint8_t> pixels; // Tightly packed
+        };
+
+        static const uint32_t FRESH = 4; // Set in middle when it holds a frame the render thread didn't take yet
+
+        void work();
+        void pushTextureOp(TextureOp &op);
+        void runTextureOps(uint64_t end);
+
+        Context *pContext = nullptr;
+
+        FramePacket packets[3];
+        uint32_t back = 0;  // UI thread's
+        uint32_t front = 1; // Render thread's
+        std::atomic<uint32_t> middle{ 2 };
+
+        std::mutex textureOpsMutex;
+        std::vector<TextureOp> textureOps; // Queued, not run yet
+        std::vector<TextureOp> runningOps; // Render thread's
+        uint64_t textureOpsBegin = 0; // Ops run so far
+        uint64_t textureOpsEnd = 0; // Ops queued so far
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        bool isStopping = false;
+        FrameStats stats; // Of the render thread's submits, not reported
+        std::thread thread;
+    };
+}
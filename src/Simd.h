@@ -0,0 +1,10 @@
+#pragma once
+
+// SIMD instruction sets available at compile time. Code using them must keep a scalar fallback.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OGUI_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OGUI_NEON
+#include <arm_neon.h>
+#endif
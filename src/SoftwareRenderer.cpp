@@ -0,0 +1,522 @@
+#include "SoftwareRenderer.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ogui
+{
+    static const int32_t TILE_SIZE = 64;
+
+    static void UnpackColor(uint32_t color32, float *pOut)
+    {
+        pOut[0] = (float)((color32 >> 24) & 0xFF);
+        pOut[1] = (float)((color32 >> 16) & 0xFF);
+        pOut[2] = (float)((color32 >> 8) & 0xFF);
+        pOut[3] = (float)(color32 & 0xFF);
+    }
+
+#if defined(OGUI_SSE2)
+    // Non-premultiplied source over destination, one RGBA pixel as floats 0-255
+    static __m128 BlendColor(__m128 src, __m128 dst)
+    {
+        auto srcA = _mm_mul_ps(_mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_ps(1.0f / 255.0f));
+        auto srcFactor = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+        srcFactor = _mm_or_ps(_mm_andnot_ps(_mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1)), srcA), srcFactor); // srcA, srcA, srcA, 1
+        return _mm_add_ps(_mm_mul_ps(src, srcFactor), _mm_mul_ps(dst, _mm_sub_ps(_mm_set1_ps(1.0f), srcA)));
+    }
+#endif
+
+    // Blends a non-premultiplied RGBA color (0-255) over a framebuffer pixel
+    static void BlendPixel(uint8_t *pDst, const float *pSrc)
+    {
+#if defined(OGUI_SSE2)
+        int32_t dst32;
+        memcpy(&dst32, pDst, 4);
+        auto dst = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(dst32), _mm_setzero_si128()), _mm_setzero_si128()));
+        auto outI = _mm_cvtps_epi32(BlendColor(_mm_loadu_ps(pSrc), dst));
+        outI = _mm_packs_epi32(outI, outI);
+        dst32 = _mm_cvtsi128_si32(_mm_packus_epi16(outI, outI));
+        memcpy(pDst, &dst32, 4);
+#else
+        auto srcA = pSrc[3] / 255.0f;
+        for (int c = 0; c < 3; ++c)
+        {
+            pDst[c] = (uint8_t)std::min(std::max(std::nearbyint(pSrc[c] * srcA + (float)pDst[c] * (1.0f - srcA)), 0.0f), 255.0f);
+        }
+        pDst[3] = (uint8_t)std::min(std::max(std::nearbyint(pSrc[3] + (float)pDst[3] * (1.0f - srcA)), 0.0f), 255.0f);
+#endif
+    }
+
+    // Same as BlendPixel on 4 consecutive pixels, with one 16 bytes load and store. pSrc holds 4 RGBA colors.
+    static void BlendPixels4(uint8_t *pDst, const float *pSrc)
+    {
+#if defined(OGUI_SSE2)
+        auto zero = _mm_setzero_si128();
+        auto dst8 = _mm_loadu_si128((const __m128i *)pDst);
+        auto dst16Lo = _mm_unpacklo_epi8(dst8, zero);
+        auto dst16Hi = _mm_unpackhi_epi8(dst8, zero);
+        auto out0 = _mm_cvtps_epi32(BlendColor(_mm_loadu_ps(pSrc), _mm_cvtepi32_ps(_mm_unpacklo_epi16(dst16Lo, zero))));
+        auto out1 = _mm_cvtps_epi32(BlendColor(_mm_loadu_ps(pSrc + 4), _mm_cvtepi32_ps(_mm_unpackhi_epi16(dst16Lo, zero))));
+        auto out2 = _mm_cvtps_epi32(BlendColor(_mm_loadu_ps(pSrc + 8), _mm_cvtepi32_ps(_mm_unpacklo_epi16(dst16Hi, zero))));
+        auto out3 = _mm_cvtps_epi32(BlendColor(_mm_loadu_ps(pSrc + 12), _mm_cvtepi32_ps(_mm_unpackhi_epi16(dst16Hi, zero))));
+        _mm_storeu_si128((__m128i *)pDst, _mm_packus_epi16(_mm_packs_epi32(out0, out1), _mm_packs_epi32(out2, out3)));
+#else
+        for (int i = 0; i < 4; ++i) BlendPixel(pDst + i * 4, pSrc + i * 4);
+#endif
+    }
+
+    ISoftwareRenderer *ISoftwareRenderer::create(uint32_t width, uint32_t height, uint32_t threadCount)
+    {
+        return new SoftwareRenderer(width, height, threadCount);
+    }
+
+    SoftwareRenderer::SoftwareRenderer(uint32_t in_width, uint32_t in_height, uint32_t threadCount)
+        : nextTile(0)
+    {
+        resize(in_width, in_height);
+
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (uint32_t i = 1; i < threadCount; ++i) // Calling thread also works
+        {
+            workers.emplace_back(&SoftwareRenderer::workerMain, this);
+        }
+    }
+
+    SoftwareRenderer::~SoftwareRenderer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            quit = true;
+        }
+        workCondition.notify_all();
+        for (auto &worker : workers) worker.join();
+    }
+
+    void SoftwareRenderer::resize(uint32_t in_width, uint32_t in_height)
+    {
+        width = in_width;
+        height = in_height;
+        pixels.assign(width * height * 4, 0);
+
+        tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+        tileBins.resize(tilesX * tilesY);
+    }
+
+    RendererCaps SoftwareRenderer::getCaps() const
+    {
+        RendererCaps caps;
+        caps.indexedDraw = true;
+        caps.partialRedraw = true; // The framebuffer is never discarded
+        caps.textureRegionUpdate = true;
+        return caps;
+    }
+
+    uintptr_t SoftwareRenderer::createTexture(uint32_t in_width, uint32_t in_height, uint8_t *pData)
+    {
+        auto id = nextTextureId++;
+        auto &texture = textures[id];
+        texture.width = in_width;
+        texture.height = in_height;
+        if (pData) texture.pixels.assign(pData, pData + in_width * in_height * 4);
+        else texture.pixels.assign(in_width * in_height * 4, 0);
+        return id;
+    }
+
+    uintptr_t SoftwareRenderer::updateTexture(uintptr_t textureId, uint32_t in_width, uint32_t in_height, uint8_t *pData)
+    {
+        auto it = textures.find(textureId);
+        if (it == textures.end()) return createTexture(in_width, in_height, pData);
+
+        it->second.width = in_width;
+        it->second.height = in_height;
+        if (pData) it->second.pixels.assign(pData, pData + in_width * in_height * 4);
+        else it->second.pixels.assign(in_width * in_height * 4, 0);
+        return textureId;
+    }
+
+    void SoftwareRenderer::updateTextureRegion(uintptr_t textureId, uint32_t x, uint32_t y, uint32_t in_width, uint32_t in_height, uint32_t stride, const uint8_t *pData)
+    {
+        auto it = textures.find(textureId);
+        if (it == textures.end()) return;
+
+        auto &texture = it->second;
+        if (x + in_width > texture.width || y + in_height > texture.height) return;
+        for (uint32_t row = 0; row < in_height; ++row)
+        {
+            memcpy(texture.pixels.data() + ((y + row) * texture.width + x) * 4, pData + row * stride, in_width * 4);
+        }
+    }
+
+    void SoftwareRenderer::destroyTexture(uintptr_t textureId)
+    {
+        textures.erase(textureId);
+    }
+
+    void SoftwareRenderer::beginFrame()
+    {
+        std::fill(pixels.begin(), pixels.end(), (uint8_t)0);
+        beginFrame(nullptr, 0);
+    }
+
+    void SoftwareRenderer::beginFrame(const Rect * /*pDamageRects*/, uint32_t /*count*/)
+    {
+        // Previous content is kept, ogui scissors each damaged area itself
+        scissor(0, 0, width, height);
+        pBoundTexture = nullptr;
+    }
+
+    void SoftwareRenderer::setVertexData(const Vertex *pData, uint32_t count)
+    {
+        vertices.assign(pData, pData + count);
+    }
+
+    void SoftwareRenderer::setIndexData(const uint32_t *pData, uint32_t count)
+    {
+        indices.assign(pData, pData + count);
+    }
+
+    void SoftwareRenderer::scissor(uint32_t x, uint32_t y, uint32_t in_width, uint32_t in_height)
+    {
+        scissorRect[0] = (int32_t)std::min(x, width);
+        scissorRect[1] = (int32_t)std::min(y, height);
+        scissorRect[2] = (int32_t)std::min(x + in_width, width);
+        scissorRect[3] = (int32_t)std::min(y + in_height, height);
+    }
+
+    void SoftwareRenderer::bindTexture(uintptr_t textureId)
+    {
+        auto it = textures.find(textureId);
+        pBoundTexture = it == textures.end() ? nullptr : &it->second;
+    }
+
+    void SoftwareRenderer::draw(uint32_t startOffset, uint32_t count)
+    {
+        for (uint32_t i = startOffset; i + 2 < startOffset + count && i + 2 < (uint32_t)vertices.size(); i += 3)
+        {
+            addTriangle(vertices[i], vertices[i + 1], vertices[i + 2]);
+        }
+    }
+
+    void SoftwareRenderer::drawIndexed(uint32_t startIndex, uint32_t count)
+    {
+        auto vertexCount = (uint32_t)vertices.size();
+        for (uint32_t i = startIndex; i + 2 < startIndex + count && i + 2 < (uint32_t)indices.size(); i += 3)
+        {
+            auto i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+            if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) continue;
+            addTriangle(vertices[i0], vertices[i1], vertices[i2]);
+        }
+    }
+
+    void SoftwareRenderer::userDraw(UserDrawFn userDrawFn, void *pUserData, const uint32_t *viewport)
+    {
+        // Keep draw order: everything before has to be in the framebuffer first
+        rasterize();
+        if (userDrawFn) userDrawFn(pUserData, viewport);
+    }
+
+    void SoftwareRenderer::endFrame()
+    {
+        rasterize();
+    }
+
+    void SoftwareRenderer::addTriangle(const Vertex &v0, const Vertex &v1, const Vertex &v2)
+    {
+        const Vertex *v[3] = { &v0, &v1, &v2 };
+        auto area = (v1.position.x - v0.position.x) * (v2.position.y - v0.position.y) - (v1.position.y - v0.position.y) * (v2.position.x - v0.position.x);
+        if (area == 0.0f) return;
+        if (area < 0.0f)
+        {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        Triangle triangle;
+
+        // Bounds
+        auto minX = std::min(std::min(v0.position.x, v1.position.x), v2.position.x);
+        auto minY = std::min(std::min(v0.position.y, v1.position.y), v2.position.y);
+        auto maxX = std::max(std::max(v0.position.x, v1.position.x), v2.position.x);
+        auto maxY = std::max(std::max(v0.position.y, v1.position.y), v2.position.y);
+        triangle.minX = std::max((int32_t)std::max(std::floor(minX), -1.0f), scissorRect[0]);
+        triangle.minY = std::max((int32_t)std::max(std::floor(minY), -1.0f), scissorRect[1]);
+        triangle.maxX = std::min((int32_t)std::min(std::ceil(maxX), (float)width + 1.0f), scissorRect[2]);
+        triangle.maxY = std::min((int32_t)std::min(std::ceil(maxY), (float)height + 1.0f), scissorRect[3]);
+        if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY) return;
+
+        // Edge i is opposite to vertex i. Shared edges are seen with opposite directions by the two triangles, so the tie rule gives each pixel to exactly one of them.
+        for (int i = 0; i < 3; ++i)
+        {
+            const auto &a = v[(i + 1) % 3]->position;
+            const auto &b = v[(i + 2) % 3]->position;
+            triangle.edgeA[i] = a.y - b.y;
+            triangle.edgeB[i] = b.x - a.x;
+            triangle.edgeC[i] = -triangle.edgeB[i] * a.y - triangle.edgeA[i] * a.x;
+            triangle.edgeTie[i] = triangle.edgeA[i] > 0.0f || (triangle.edgeA[i] == 0.0f && triangle.edgeB[i] > 0.0f);
+        }
+
+        // Attribute planes from barycentric weights
+        triangle.pTexture = pBoundTexture;
+        auto texWidth = pBoundTexture ? (float)pBoundTexture->width : 1.0f;
+        auto texHeight = pBoundTexture ? (float)pBoundTexture->height : 1.0f;
+        float colors[3][4];
+        float uvs[3][2];
+        for (int i = 0; i < 3; ++i)
+        {
+            UnpackColor(v[i]->color, colors[i]);
+            uvs[i][0] = v[i]->uv.x * texWidth;
+            uvs[i][1] = v[i]->uv.y * texHeight;
+        }
+        auto invArea = 1.0f / area;
+        for (int c = 0; c < 4; ++c)
+        {
+            triangle.colorDx[c] = (triangle.edgeA[0] * colors[0][c] + triangle.edgeA[1] * colors[1][c] + triangle.edgeA[2] * colors[2][c]) * invArea;
+            triangle.colorDy[c] = (triangle.edgeB[0] * colors[0][c] + triangle.edgeB[1] * colors[1][c] + triangle.edgeB[2] * colors[2][c]) * invArea;
+            triangle.colorC[c] = (triangle.edgeC[0] * colors[0][c] + triangle.edgeC[1] * colors[1][c] + triangle.edgeC[2] * colors[2][c]) * invArea;
+        }
+        for (int c = 0; c < 2; ++c)
+        {
+            triangle.uvDx[c] = (triangle.edgeA[0] * uvs[0][c] + triangle.edgeA[1] * uvs[1][c] + triangle.edgeA[2] * uvs[2][c]) * invArea;
+            triangle.uvDy[c] = (triangle.edgeB[0] * uvs[0][c] + triangle.edgeB[1] * uvs[1][c] + triangle.edgeB[2] * uvs[2][c]) * invArea;
+            triangle.uvC[c] = (triangle.edgeC[0] * uvs[0][c] + triangle.edgeC[1] * uvs[1][c] + triangle.edgeC[2] * uvs[2][c]) * invArea;
+        }
+
+        // Most UI triangles are a single color sampling a single texel (the white one)
+        triangle.isSolid = false;
+        if (v0.color == v1.color && v1.color == v2.color)
+        {
+            int32_t texels[3][2];
+            for (int i = 0; i < 3; ++i)
+            {
+                texels[i][0] = (int32_t)std::floor(uvs[i][0]);
+                texels[i][1] = (int32_t)std::floor(uvs[i][1]);
+            }
+            if (texels[0][0] == texels[1][0] && texels[1][0] == texels[2][0] &&
+                texels[0][1] == texels[1][1] && texels[1][1] == texels[2][1])
+            {
+                uint8_t texel[4] = { 255, 255, 255, 255 };
+                if (pBoundTexture)
+                {
+                    auto tx = std::min(std::max(texels[0][0], 0), (int32_t)pBoundTexture->width - 1);
+                    auto ty = std::min(std::max(texels[0][1], 0), (int32_t)pBoundTexture->height - 1);
+                    memcpy(texel, pBoundTexture->pixels.data() + (ty * pBoundTexture->width + tx) * 4, 4);
+                }
+                triangle.isSolid = true;
+                for (int c = 0; c < 4; ++c)
+                {
+                    triangle.solid[c] = (uint8_t)std::nearbyint((float)texel[c] * colors[0][c] / 255.0f);
+                }
+            }
+        }
+
+        auto triangleIndex = (uint32_t)triangles.size();
+        triangles.push_back(triangle);
+
+        // Bin into tiles
+        for (auto ty = triangle.minY / TILE_SIZE; ty <= (triangle.maxY - 1) / TILE_SIZE; ++ty)
+        {
+            for (auto tx = triangle.minX / TILE_SIZE; tx <= (triangle.maxX - 1) / TILE_SIZE; ++tx)
+            {
+                tileBins[ty * tilesX + tx].push_back(triangleIndex);
+            }
+        }
+    }
+
+    void SoftwareRenderer::rasterize()
+    {
+        if (triangles.empty()) return;
+
+        nextTile = 0;
+        if (!workers.empty())
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            workersBusy = (uint32_t)workers.size();
+            ++workGeneration;
+        }
+        workCondition.notify_all();
+
+        auto tileCount = tilesX * tilesY;
+        for (auto tile = nextTile++; tile < tileCount; tile = nextTile++)
+        {
+            rasterizeTile(tile);
+        }
+
+        if (!workers.empty())
+        {
+            std::unique_lock<std::mutex> lock(workMutex);
+            doneCondition.wait(lock, [this] { return workersBusy == 0; });
+        }
+
+        triangles.clear();
+        for (auto &bin : tileBins) bin.clear();
+    }
+
+    void SoftwareRenderer::workerMain()
+    {
+        uint32_t lastGeneration = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(workMutex);
+                workCondition.wait(lock, [&] { return quit || workGeneration != lastGeneration; });
+                if (quit) return;
+                lastGeneration = workGeneration;
+            }
+
+            auto tileCount = tilesX * tilesY;
+            for (auto tile = nextTile++; tile < tileCount; tile = nextTile++)
+            {
+                rasterizeTile(tile);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(workMutex);
+                --workersBusy;
+            }
+            doneCondition.notify_one();
+        }
+    }
+
+    void SoftwareRenderer::rasterizeTile(uint32_t tileIndex)
+    {
+        const auto &bin = tileBins[tileIndex];
+        if (bin.empty()) return;
+
+        auto tileX1 = (int32_t)(tileIndex % tilesX) * TILE_SIZE;
+        auto tileY1 = (int32_t)(tileIndex / tilesX) * TILE_SIZE;
+        auto tileX2 = std::min(tileX1 + TILE_SIZE, (int32_t)width);
+        auto tileY2 = std::min(tileY1 + TILE_SIZE, (int32_t)height);
+
+        // Triangles are processed in submission order, so each tile blends like a serial renderer would
+        for (auto triangleIndex : bin)
+        {
+            const auto &triangle = triangles[triangleIndex];
+            auto minX = std::max(triangle.minX, tileX1);
+            auto maxX = std::min(triangle.maxX, tileX2);
+            auto y1 = std::max(triangle.minY, tileY1);
+            auto y2 = std::min(triangle.maxY, tileY2);
+
+            for (auto y = y1; y < y2; ++y)
+            {
+                auto py = (float)y + 0.5f;
+                float rowC[3];
+                for (int i = 0; i < 3; ++i) rowC[i] = triangle.edgeB[i] * py + triangle.edgeC[i];
+
+                auto isInside = [&](int32_t x)
+                {
+                    auto px = (float)x + 0.5f;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto e = triangle.edgeA[i] * px + rowC[i];
+                        if (e < 0.0f || (e == 0.0f && !triangle.edgeTie[i])) return false;
+                    }
+                    return true;
+                };
+
+                // Solve each edge for x to find the span, then fix float imprecision at both ends
+                auto x1 = (float)minX;
+                auto x2 = (float)maxX;
+                bool isEmpty = false;
+                for (int i = 0; i < 3; ++i)
+                {
+                    auto a = triangle.edgeA[i];
+                    if (a > 0.0f) x1 = std::max(x1, std::ceil(-rowC[i] / a - 0.5f));
+                    else if (a < 0.0f) x2 = std::min(x2, std::floor(-rowC[i] / a - 0.5f) + 1.0f);
+                    else if (rowC[i] < 0.0f || (rowC[i] == 0.0f && !triangle.edgeTie[i])) isEmpty = true;
+                }
+                if (isEmpty || x1 >= x2) continue;
+
+                auto spanX1 = (int32_t)x1;
+                auto spanX2 = (int32_t)x2;
+                while (spanX1 < spanX2 && !isInside(spanX1)) ++spanX1;
+                while (spanX2 > spanX1 && !isInside(spanX2 - 1)) --spanX2;
+                if (spanX1 >= spanX2) continue;
+                while (spanX1 > minX && isInside(spanX1 - 1)) --spanX1;
+                while (spanX2 < maxX && isInside(spanX2)) ++spanX2;
+
+                rasterizeSpan(triangle, y, spanX1, spanX2);
+            }
+        }
+    }
+
+    void SoftwareRenderer::rasterizeSpan(const Triangle &triangle, int32_t y, int32_t x1, int32_t x2)
+    {
+        auto pDst = pixels.data() + ((size_t)y * width + x1) * 4;
+        auto count = x2 - x1;
+
+        if (triangle.isSolid)
+        {
+            if (triangle.solid[3] == 255)
+            {
+                // Opaque fill, 4 pixels per store
+                uint32_t color32;
+                memcpy(&color32, triangle.solid, 4);
+                int32_t i = 0;
+#if defined(OGUI_SSE2)
+                auto color4 = _mm_set1_epi32((int32_t)color32);
+                for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(pDst + i * 4), color4);
+#elif defined(OGUI_NEON)
+                auto color4 = vdupq_n_u32(color32);
+                for (; i + 4 <= count; i += 4) vst1q_u32((uint32_t *)(pDst + i * 4), color4);
+#endif
+                for (; i < count; ++i) memcpy(pDst + i * 4, &color32, 4);
+                return;
+            }
+
+            if (triangle.solid[3] == 0) return;
+
+            // Translucent fill, 4 pixels per blend
+            float src[16];
+            for (int c = 0; c < 16; ++c) src[c] = (float)triangle.solid[c % 4];
+            int32_t i = 0;
+            for (; i + 4 <= count; i += 4) BlendPixels4(pDst + i * 4, src);
+            for (; i < count; ++i) BlendPixel(pDst + i * 4, src);
+            return;
+        }
+
+        // Interpolated color and texture coordinates, stepping one pixel at a time
+        auto px = (float)x1 + 0.5f;
+        auto py = (float)y + 0.5f;
+        float color[4];
+        for (int c = 0; c < 4; ++c) color[c] = triangle.colorC[c] + triangle.colorDx[c] * px + triangle.colorDy[c] * py;
+        auto u = triangle.uvC[0] + triangle.uvDx[0] * px + triangle.uvDy[0] * py;
+        auto v = triangle.uvC[1] + triangle.uvDx[1] * px + triangle.uvDy[1] * py;
+
+        const auto pTexture = triangle.pTexture;
+        auto shade = [&](float *pSrc)
+        {
+            if (pTexture)
+            {
+                auto tx = std::min(std::max((int32_t)std::floor(u), 0), (int32_t)pTexture->width - 1);
+                auto ty = std::min(std::max((int32_t)std::floor(v), 0), (int32_t)pTexture->height - 1);
+                auto pTexel = pTexture->pixels.data() + (ty * pTexture->width + tx) * 4;
+                for (int c = 0; c < 4; ++c) pSrc[c] = (float)pTexel[c] * color[c] * (1.0f / 255.0f);
+            }
+            else
+            {
+                for (int c = 0; c < 4; ++c) pSrc[c] = color[c];
+            }
+
+            for (int c = 0; c < 4; ++c) color[c] += triangle.colorDx[c];
+            u += triangle.uvDx[0];
+            v += triangle.uvDx[1];
+        };
+
+        // Shaded 4 pixels at a time, then blended together
+        float src[16];
+        int32_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            for (int p = 0; p < 4; ++p) shade(src + p * 4);
+            BlendPixels4(pDst + i * 4, src);
+        }
+        for (; i < count; ++i)
+        {
+            shade(src);
+            BlendPixel(pDst + i * 4, src);
+        }
+    }
+}
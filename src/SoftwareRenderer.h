@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ogui/ISoftwareRenderer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ogui
+{
+    class SoftwareRenderer final : public ISoftwareRenderer
+    {
+    public:
+        SoftwareRenderer(uint32_t width, uint32_t height, uint32_t threadCount);
+        ~SoftwareRenderer();
+
+        void resize(uint32_t width, uint32_t height) override;
+        const uint8_t *getPixels() const override { return pixels.data(); }
+        uint32_t getWidth() const override { return width; }
+        uint32_t getHeight() const override { return height; }
+
+        RendererCaps getCaps() const override;
+        uintptr_t createTexture(uint32_t width, uint32_t height, uint8_t *pData) override;
+        uintptr_t updateTexture(uintptr_t textureId, uint32_t width, uint32_t height, uint8_t *pData) override;
+        void updateTextureRegion(uintptr_t textureId, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t stride, const uint8_t *pData) override;
+        void destroyTexture(uintptr_t textureId) override;
+        void beginFrame() override;
+        void beginFrame(const Rect *pDamageRects, uint32_t count) override;
+        void setVertexData(const Vertex *pData, uint32_t count) override;
+        void setIndexData(const uint32_t *pData, uint32_t count) override;
+        void scissor(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+        void bindTexture(uintptr_t textureId) override;
+        void draw(uint32_t startOffset, uint32_t count) override;
+        void drawIndexed(uint32_t startIndex, uint32_t count) override;
+        void userDraw(UserDrawFn userDrawFn, void *pUserData, const uint32_t *viewport) override;
+        void endFrame() override;
+
+    private:
+        struct Texture
+        {
+            uint32_t width, height;
+            std::vector<uint8_t> pixels;
+        };
+
+        struct Triangle
+        {
+            float edgeA[3], edgeB[3], edgeC[3]; // Edge functions: a * x + b * y + c >= 0 inside
+            bool edgeTie[3];                    // Pixels exactly on the edge belong to this triangle
+            float colorDx[4], colorDy[4], colorC[4]; // Color planes, 0-255
+            float uvDx[2], uvDy[2], uvC[2];          // Texel coordinate planes
+            int32_t minX, minY, maxX, maxY;          // Bounds, clipped to scissor. Max is exclusive.
+            const Texture *pTexture;
+            bool isSolid;       // Same color everywhere, no need to interpolate
+            uint8_t solid[4];   // RGBA when isSolid
+        };
+
+        void addTriangle(const Vertex &v0, const Vertex &v1, const Vertex &v2);
+        void rasterize();
+        void rasterizeTile(uint32_t tileIndex);
+        void rasterizeSpan(const Triangle &triangle, int32_t y, int32_t x0, int32_t x1);
+        void workerMain();
+
+        uint32_t width = 0, height = 0;
+        std::vector<uint8_t> pixels;
+
+        std::unordered_map<uintptr_t, Texture> textures;
+        uintptr_t nextTextureId = 1;
+        const Texture *pBoundTexture = nullptr;
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        int32_t scissorRect[4] = { 0, 0, 0, 0 }; // x1, y1, x2, y2
+
+        // Triangles of the current batch, and which of them touch each tile
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<uint32_t>> tileBins;
+        uint32_t tilesX = 0, tilesY = 0;
+
+        // Tile workers
+        std::vector<std::thread> workers;
+        std::mutex workMutex;
+        std::condition_variable workCondition;
+        std::condition_variable doneCondition;
+        std::atomic<uint32_t> nextTile;
+        uint32_t workGeneration = 0;
+        uint32_t workersBusy = 0;
+        bool quit = false;
+    };
+}
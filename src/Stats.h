@@ -0,0 +1,37 @@
+#pragma once
+
+// Frame stats can be compiled out with -DOGUI_STATS=0
+#ifndef OGUI_STATS
+#define OGUI_STATS 1
+#endif
+
+#if OGUI_STATS
+
+#include <chrono>
+
+namespace ogui
+{
+    // Adds the time spent in its scope to a milliseconds counter
+    class ScopedStatTimer final
+    {
+    public:
+        ScopedStatTimer(float &in_milliseconds) : milliseconds(in_milliseconds), start(std::chrono::steady_clock::now()) {}
+        ~ScopedStatTimer() { milliseconds += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+    private:
+        float &milliseconds;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+#define OGUI_STAT_CONCAT_IMPL(a, b) a##b
+#define OGUI_STAT_CONCAT(a, b) OGUI_STAT_CONCAT_IMPL(a, b)
+#define OGUI_STAT_TIMER(milliseconds) ogui::ScopedStatTimer OGUI_STAT_CONCAT(statTimer, __LINE__)(milliseconds)
+#define OGUI_STAT(expression) expression
+
+#else
+
+#define OGUI_STAT_TIMER(milliseconds)
+#define OGUI_STAT(expression)
+
+#endif
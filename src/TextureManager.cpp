@@ -0,0 +1,238 @@
+#include "TextureManager.h"
+#include "Context.h"
+#include "FrameArena.h"
+#include "RenderThread.h"
+#include "ogui/IRenderer.h"
+#include "Stats.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ogui
+{
+    static const size_t MAX_TEXTURE_DIRTY_REGIONS = 16;
+
+    static uint64_t RegionArea(const TextureRegion &region)
+    {
+        return (uint64_t)region.width * region.height;
+    }
+
+    static TextureRegion RegionUnion(const TextureRegion &a, const TextureRegion &b)
+    {
+        auto x = std::min(a.x, b.x);
+        auto y = std::min(a.y, b.y);
+        return { x, y, std::max(a.x + a.width, b.x + b.width) - x, std::max(a.y + a.height, b.y + b.height) - y };
+    }
+
+    static uint64_t TextureBytes(const Texture &texture)
+    {
+        return (uint64_t)texture.width * texture.height * 4;
+    }
+
+    TextureManager::TextureManager(Context *in_pContext)
+        : pContext(in_pContext)
+    {
+    }
+
+    TextureManager::~TextureManager()
+    {
+        // Owners release their references before the manager goes away
+        assert(textures.empty() && "Textures still referenced.");
+        for (auto pTexture : toDestroy)
+        {
+            if (pTexture->isCreated) pContext->pRenderer->destroyTexture(pTexture->id);
+            delete pTexture;
+        }
+    }
+
+    TextureRef TextureManager::create(uint32_t width, uint32_t height, uint8_t *pData, bool isCacheable, const std::function<void()> &onEvict)
+    {
+        auto pTexture = new Texture();
+        pTexture->pData = pData;
+        pTexture->width = width;
+        pTexture->height = height;
+        pTexture->isCacheable = isCacheable;
+        pTexture->onEvict = onEvict;
+        pTexture->lastUsedFrame = frame;
+        pTexture->pendingCreate = true;
+        pTexture->index = textures.size();
+
+        TextureRef texture(pTexture, [this](Texture *pTexture) { release(pTexture); });
+        textures.push_back({ pTexture, texture });
+        toCreate.push_back(pTexture);
+        bytes += TextureBytes(*pTexture);
+
+        return texture;
+    }
+
+    void TextureManager::update(Texture &texture)
+    {
+        if (texture.pendingCreate) return; // Creation uploads everything anyway
+
+        texture.dirtyRegions.clear();
+        if (!texture.pendingUpdate)
+        {
+            texture.pendingUpdate = true;
+            toUpdate.push_back(&texture);
+        }
+    }
+
+    void TextureManager::updateRegion(Texture &texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        if (texture.pendingCreate) return; // Creation uploads everything anyway
+
+        if (!texture.pendingUpdate)
+        {
+            texture.pendingUpdate = true;
+            texture.dirtyRegions.clear();
+            toUpdate.push_back(&texture);
+        }
+        else if (texture.dirtyRegions.empty())
+        {
+            return; // Already re-uploading the whole texture
+        }
+
+        // Coalesce with the regions it is next to, as long as the union doesn't upload
+        // more than 50% of pixels that didn't change. Repeat since the union can reach new neighbours.
+        TextureRegion region = { x, y, width, height };
+        auto &dirtyRegions = texture.dirtyRegions;
+        for (bool merged = true; merged;)
+        {
+            merged = false;
+            for (auto it = dirtyRegions.begin(); it != dirtyRegions.end(); ++it)
+            {
+                auto merge = RegionUnion(region, *it);
+                if (RegionArea(merge) * 2 <= (RegionArea(region) + RegionArea(*it)) * 3)
+                {
+                    region = merge;
+                    dirtyRegions.erase(it);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        dirtyRegions.push_back(region);
+
+        // Too many scattered regions, a single upload of their bounds is cheaper than that many calls
+        if (dirtyRegions.size() > MAX_TEXTURE_DIRTY_REGIONS)
+        {
+            auto bounds = dirtyRegions.front();
+            for (const auto &dirtyRegion : dirtyRegions) bounds = RegionUnion(bounds, dirtyRegion);
+            dirtyRegions.clear();
+            dirtyRegions.push_back(bounds);
+        }
+    }
+
+    void TextureManager::release(Texture *pTexture)
+    {
+        // Swap remove from the live textures
+        auto index = pTexture->index;
+        textures[index] = textures.back();
+        textures[index].pTexture->index = index;
+        textures.pop_back();
+        bytes -= TextureBytes(*pTexture);
+
+        if (pTexture->pendingCreate) toCreate.erase(std::find(toCreate.begin(), toCreate.end(), pTexture));
+        if (pTexture->pendingUpdate) toUpdate.erase(std::find(toUpdate.begin(), toUpdate.end(), pTexture));
+
+        // Draw commands of the frame being generated may still point to it
+        toDestroy.push_back(pTexture);
+    }
+
+    void TextureManager::evict()
+    {
+        // Least recently used first. Textures referenced by draw caches are on screen and can't go.
+        ArenaVector<Texture *> candidates(ArenaAllocator<Texture *>(pContext->pFrameArena));
+        for (const auto &entry : textures)
+        {
+            if (entry.pTexture->isCacheable && entry.pTexture->onEvict && entry.weak.use_count() == 1 && entry.pTexture->lastUsedFrame < frame)
+            {
+                candidates.push_back(entry.pTexture);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Texture *a, const Texture *b) { return a->lastUsedFrame < b->lastUsedFrame; });
+
+        for (auto pTexture : candidates)
+        {
+            if (bytes <= budget) break;
+            auto onEvict = pTexture->onEvict; // The texture is released during the call
+            onEvict();
+        }
+    }
+
+    void TextureManager::collect()
+    {
+        if (budget && bytes > budget) evict();
+        ++frame;
+
+        if (toDestroy.empty()) return;
+
+        OGUI_TRACE_ZONE("TextureManager::collect");
+        OGUI_STAT_TIMER(pContext->pendingStats.textureTime);
+
+        auto pRenderThread = pContext->pRenderThread;
+        for (auto pTexture : toDestroy)
+        {
+            OGUI_STAT(pContext->pendingStats.textureDestroyCount += pTexture->isCreated);
+            if (pRenderThread)
+            {
+                pRenderThread->destroyTexture(pTexture, pTexture->isCreated); // Once no frame can bind it anymore
+                continue;
+            }
+            if (pTexture->isCreated) pContext->pRenderer->destroyTexture(pTexture->id);
+            delete pTexture;
+        }
+        toDestroy.clear();
+    }
+
+    void TextureManager::upload()
+    {
+        if (toCreate.empty() && toUpdate.empty()) return;
+
+        OGUI_TRACE_ZONE("TextureManager::upload");
+        OGUI_STAT_TIMER(pContext->pendingStats.textureTime);
+
+        auto pRenderer = pContext->pRenderer;
+        auto pRenderThread = pContext->pRenderThread; // Queues the calls, the render thread makes them
+
+        // Create textures
+        for (auto pTexture : toCreate)
+        {
+            if (pRenderThread) pRenderThread->createTexture(*pTexture);
+            else pTexture->id = pRenderer->createTexture(pTexture->width, pTexture->height, pTexture->pData);
+            pTexture->isCreated = true;
+            pTexture->pendingCreate = false;
+            pTexture->dirtyRegions.clear();
+            OGUI_STAT(++pContext->pendingStats.textureCreateCount);
+            OGUI_STAT(pContext->pendingStats.bytesUploaded += TextureBytes(*pTexture));
+        }
+        toCreate.clear();
+
+        // Update textures
+        for (auto pTexture : toUpdate)
+        {
+            if (pContext->caps.textureRegionUpdate && !pTexture->dirtyRegions.empty())
+            {
+                auto stride = pTexture->width * 4;
+                for (const auto &region : pTexture->dirtyRegions)
+                {
+                    if (pRenderThread) pRenderThread->updateTextureRegion(*pTexture, region);
+                    else pRenderer->updateTextureRegion(pTexture->id, region.x, region.y, region.width, region.height, stride, pTexture->pData + region.y * stride + region.x * 4);
+                    OGUI_STAT(++pContext->pendingStats.textureUpdateCount);
+                    OGUI_STAT(pContext->pendingStats.bytesUploaded += RegionArea(region) * 4);
+                }
+            }
+            else
+            {
+                if (pRenderThread) pRenderThread->updateTexture(*pTexture);
+                else pTexture->id = pRenderer->updateTexture(pTexture->id, pTexture->width, pTexture->height, pTexture->pData);
+                OGUI_STAT(++pContext->pendingStats.textureUpdateCount);
+                OGUI_STAT(pContext->pendingStats.bytesUploaded += TextureBytes(*pTexture));
+            }
+            pTexture->pendingUpdate = false;
+            pTexture->dirtyRegions.clear();
+        }
+        toUpdate.clear();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cinttypes>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ogui
+{
+    class Context;
+
+    struct TextureRegion
+    {
+        uint32_t x, y, width, height;
+    };
+
+    struct Texture : public std::enable_shared_from_this<Texture>
+    {
+        uint8_t *pData = nullptr;
+        uint32_t width = 0, height = 0;
+        uintptr_t id = 0;
+        std::vector<TextureRegion> dirtyRegions; // Parts to upload on the next update. Empty re-uploads the whole texture.
+
+        // Owned by TextureManager
+        bool isCreated = false;
+        bool isCacheable = false;
+        bool pendingCreate = false;
+        bool pendingUpdate = false;
+        size_t index = 0; // In TextureManager::textures
+        mutable uint64_t lastUsedFrame = 0;
+        std::function<void()> onEvict; // Owner must drop its TextureRef
+    };
+
+    using TextureRef = std::shared_ptr<Texture>;
+
+    // Owns every texture ogui uploads to the renderer. Textures are handed out as ref-counted TextureRef,
+    // and draw caches hold references to the textures they bind, so nothing is destroyed while it can still be drawn.
+    // Creations and updates are queued, each texture at most once, and flushed by upload().
+    // Destruction is deferred to collect(), which is only called at the start of a frame.
+    // With a render thread, the renderer calls are queued to it instead, and it deletes destroyed textures.
+    class TextureManager final
+    {
+    public:
+        TextureManager(Context *pContext);
+        ~TextureManager();
+
+        // Cacheable textures can be evicted when over budget. Their owner must be able to recreate them on demand.
+        TextureRef create(uint32_t width, uint32_t height, uint8_t *pData, bool isCacheable = false, const std::function<void()> &onEvict = nullptr);
+        void update(Texture &texture);
+        void updateRegion(Texture &texture, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+        void touch(const Texture &texture) const { texture.lastUsedFrame = frame; }
+
+        void collect(); // Evicts over budget and destroys released textures
+        void upload();  // Creates and updates queued textures
+
+        void setBudget(uint64_t bytes) { budget = bytes; }
+        uint64_t getBudget() const { return budget; }
+        uint64_t getBytes() const { return bytes; }
+
+    private:
+        struct Entry
+        {
+            Texture *pTexture;
+            std::weak_ptr<Texture> weak; // Tells if anyone but the owner holds a reference
+        };
+
+        void release(Texture *pTexture);
+        void evict();
+
+        Context *pContext = nullptr;
+        std::vector<Entry> textures;
+        std::vector<Texture *> toCreate;
+        std::vector<Texture *> toUpdate;
+        std::vector<Texture *> toDestroy;
+        uint64_t budget = 0; // In bytes, 0 is unlimited
+        uint64_t bytes = 0;
+        uint64_t frame = 1;
+    };
+}
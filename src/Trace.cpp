@@ -0,0 +1,144 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ogui
+{
+#if OGUI_TRACE
+    static const uint32_t TRACE_BUFFER_SIZE = 16384; // Zones kept per thread. Power of 2.
+
+    std::atomic<bool> g_traceEnabled(false);
+
+    struct TraceEvent
+    {
+        const char *name;
+        uint64_t start, end;
+    };
+
+    // Written only by its thread. Readers use head to know which events are complete and not yet overwritten.
+    struct TraceBuffer
+    {
+        std::atomic<uint64_t> head;
+        uint64_t clearedHead = 0; // Events before it were cleared. Only used under g_traceBuffersMutex.
+        uint32_t threadId;
+        TraceEvent events[TRACE_BUFFER_SIZE];
+    };
+
+    // Buffers outlive their threads, so zones of finished threads still show in the dump
+    static std::mutex g_traceBuffersMutex;
+    static std::vector<std::unique_ptr<TraceBuffer>> g_traceBuffers;
+
+    static TraceBuffer *GetThreadTraceBuffer()
+    {
+        thread_local TraceBuffer *pBuffer = nullptr;
+        if (pBuffer) return pBuffer;
+
+        std::lock_guard<std::mutex> lock(g_traceBuffersMutex);
+        g_traceBuffers.emplace_back(new TraceBuffer());
+        pBuffer = g_traceBuffers.back().get();
+        pBuffer->head.store(0, std::memory_order_relaxed);
+        pBuffer->threadId = (uint32_t)g_traceBuffers.size();
+        return pBuffer;
+    }
+
+    uint64_t GetTraceTime()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void RecordTraceZone(const char *name, uint64_t start, uint64_t end)
+    {
+        auto pBuffer = GetThreadTraceBuffer();
+        auto head = pBuffer->head.load(std::memory_order_relaxed);
+        pBuffer->events[head & (TRACE_BUFFER_SIZE - 1)] = { name, start, end };
+        pBuffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    static void AppendEscaped(std::string &json, const char *text)
+    {
+        for (; *text; ++text)
+        {
+            if (*text == '"' || *text == '\\') json += '\\';
+            json += *text;
+        }
+    }
+#endif
+
+    void setTraceEnabled(bool enabled)
+    {
+#if OGUI_TRACE
+        g_traceEnabled.store(enabled, std::memory_order_relaxed);
+#endif
+    }
+
+    bool isTraceEnabled()
+    {
+#if OGUI_TRACE
+        return g_traceEnabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    std::string getChromeTrace()
+    {
+        std::string json = "{\"traceEvents\":[";
+#if OGUI_TRACE
+        std::lock_guard<std::mutex> lock(g_traceBuffersMutex);
+
+        bool first = true;
+        std::vector<TraceEvent> events;
+        for (const auto &pBuffer : g_traceBuffers)
+        {
+            // Copy, then drop what the owner thread might have overwritten while we were copying
+            auto headBefore = pBuffer->head.load(std::memory_order_acquire);
+            auto count = std::min<uint64_t>(headBefore - pBuffer->clearedHead, TRACE_BUFFER_SIZE);
+            events.clear();
+            for (auto i = headBefore - count; i < headBefore; ++i)
+            {
+                events.push_back(pBuffer->events[i & (TRACE_BUFFER_SIZE - 1)]);
+            }
+            auto headAfter = pBuffer->head.load(std::memory_order_acquire);
+            auto overwritten = headAfter - headBefore;
+
+            // When full, the oldest slot is the one the owner writes next, before publishing it. It can be torn.
+            if (count == TRACE_BUFFER_SIZE) ++overwritten;
+            auto skip = (size_t)std::min<uint64_t>(overwritten, events.size());
+
+            for (size_t i = skip; i < events.size(); ++i)
+            {
+                const auto &event = events[i];
+                char numbers[128];
+                snprintf(numbers, sizeof(numbers), "\",\"ph\":\"X\",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"dur\":%" PRIu64 ".%03" PRIu64 ",\"pid\":1,\"tid\":%u}",
+                         event.start / 1000, event.start % 1000, (event.end - event.start) / 1000, (event.end - event.start) % 1000, pBuffer->threadId);
+
+                if (!first) json += ',';
+                first = false;
+                json += "{\"name\":\"";
+                AppendEscaped(json, event.name);
+                json += numbers;
+            }
+        }
+#endif
+        json += "]}";
+        return json;
+    }
+
+    void clearTrace()
+    {
+#if OGUI_TRACE
+        // Head belongs to the owner thread, the dump just starts after what is there now
+        std::lock_guard<std::mutex> lock(g_traceBuffersMutex);
+        for (const auto &pBuffer : g_traceBuffers)
+        {
+            pBuffer->clearedHead = pBuffer->head.load(std::memory_order_acquire);
+        }
+#endif
+    }
+}
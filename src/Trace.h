@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ogui/Trace.h"
+
+// Trace zones can be compiled out with -DOGUI_TRACE=0
+#ifndef OGUI_TRACE
+#define OGUI_TRACE 1
+#endif
+
+#if OGUI_TRACE
+
+#include <atomic>
+#include <cstdint>
+
+namespace ogui
+{
+    extern std::atomic<bool> g_traceEnabled;
+
+    uint64_t GetTraceTime(); // Nanoseconds, steady clock
+    void RecordTraceZone(const char *name, uint64_t start, uint64_t end);
+
+    // Records the time spent in its scope. Name must be a string literal, only the pointer is kept.
+    class ScopedTraceZone final
+    {
+    public:
+        ScopedTraceZone(const char *in_name)
+            : name(g_traceEnabled.load(std::memory_order_relaxed) ? in_name : nullptr)
+            , start(name ? GetTraceTime() : 0)
+        {
+        }
+
+        ~ScopedTraceZone()
+        {
+            if (name) RecordTraceZone(name, start, GetTraceTime());
+        }
+
+    private:
+        const char *name;
+        uint64_t start;
+    };
+}
+
+#define OGUI_TRACE_CONCAT_IMPL(a, b) a##b
+#define OGUI_TRACE_CONCAT(a, b) OGUI_TRACE_CONCAT_IMPL(a, b)
+#define OGUI_TRACE_ZONE(name) ogui::ScopedTraceZone OGUI_TRACE_CONCAT(traceZone, __LINE__)(name)
+
+#else
+
+#define OGUI_TRACE_ZONE(name)
+
+#endif
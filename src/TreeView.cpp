@@ -0,0 +1,231 @@
+#include "TreeView.h"
+#include "Context.h"
+
+#include <algorithm>
+
+namespace ogui
+{
+    ITreeViewRef ITreeView::create(ITreeDataSource *pDataSource)
+    {
+        return std::shared_ptr<TreeView>(new TreeView(pDataSource));
+    }
+
+    TreeView::TreeView(ITreeDataSource *in_pDataSource)
+        : pDataSource(in_pDataSource)
+    {
+        nodes.emplace_back();
+        nodes[0].rowCount = pDataSource ? pDataSource->getChildCount(TREE_ROOT) : 0;
+    }
+
+    void TreeView::setDataSource(ITreeDataSource *in_pDataSource)
+    {
+        pDataSource = in_pDataSource;
+        collapseAll();
+    }
+
+    TreeView::Location TreeView::locate(uint32_t row) const
+    {
+        auto node = 0u;
+        while (true)
+        {
+            // Rows before an expanded child are its index, plus the rows of the expanded children before it
+            const auto &expandedNode = nodes[node];
+            uint32_t rowsBefore = 0;
+            uint32_t next = NONE;
+            for (auto child : expandedNode.expandedChildren)
+            {
+                const auto &childNode = nodes[child];
+                auto childRow = childNode.childIndex + rowsBefore;
+                if (row < childRow) break;
+                if (row == childRow) return { node, childNode.childIndex, child };
+                if (row <= childRow + childNode.rowCount)
+                {
+                    row -= childRow + 1;
+                    next = child;
+                    break;
+                }
+                rowsBefore += childNode.rowCount;
+            }
+
+            if (next == NONE) return { node, row - rowsBefore, NONE };
+            node = next;
+        }
+    }
+
+    uint64_t TreeView::getItem(uint32_t row) const
+    {
+        auto location = locate(row);
+        if (location.node != NONE) return nodes[location.node].item;
+        return pDataSource->getChild(nodes[location.parent].item, location.childIndex);
+    }
+
+    bool TreeView::isExpanded(uint32_t row) const
+    {
+        return locate(row).node != NONE;
+    }
+
+    uint32_t TreeView::allocNode()
+    {
+        if (freeNodes.empty())
+        {
+            nodes.emplace_back();
+            return (uint32_t)nodes.size() - 1;
+        }
+
+        auto node = freeNodes.back();
+        freeNodes.pop_back();
+        return node;
+    }
+
+    void TreeView::freeSubtree(uint32_t node)
+    {
+        stack.clear();
+        stack.push_back(node);
+        while (!stack.empty())
+        {
+            auto &expandedNode = nodes[stack.back()];
+            freeNodes.push_back(stack.back());
+            stack.pop_back();
+
+            stack.insert(stack.end(), expandedNode.expandedChildren.begin(), expandedNode.expandedChildren.end());
+            expandedNode.expandedChildren.clear(); // Keeps capacity for reuse
+            expandedNode.parent = NONE;
+        }
+    }
+
+    void TreeView::addRows(uint32_t node, int64_t delta)
+    {
+        for (; node != NONE; node = nodes[node].parent) nodes[node].rowCount = (uint32_t)((int64_t)nodes[node].rowCount + delta);
+    }
+
+    void TreeView::setExpanded(uint32_t row, bool expanded)
+    {
+        if (!pDataSource || row >= getRowCount()) return;
+
+        auto location = locate(row);
+        if (expanded == (location.node != NONE)) return;
+
+        if (expanded)
+        {
+            auto item = pDataSource->getChild(nodes[location.parent].item, location.childIndex);
+            auto childCount = pDataSource->getChildCount(item);
+            if (!childCount) return;
+
+            auto node = allocNode();
+            auto &expandedNode = nodes[node];
+            expandedNode.item = item;
+            expandedNode.parent = location.parent;
+            expandedNode.childIndex = location.childIndex;
+            expandedNode.depth = nodes[location.parent].depth + 1;
+            expandedNode.rowCount = 0;
+
+            auto &siblings = nodes[location.parent].expandedChildren;
+            auto it = std::lower_bound(siblings.begin(), siblings.end(), location.childIndex, [this](uint32_t sibling, uint32_t childIndex)
+            {
+                return nodes[sibling].childIndex < childIndex;
+            });
+            siblings.insert(it, node);
+            addRows(node, childCount);
+        }
+        else
+        {
+            auto &siblings = nodes[location.parent].expandedChildren;
+            siblings.erase(std::find(siblings.begin(), siblings.end(), location.node));
+            addRows(location.parent, -(int64_t)nodes[location.node].rowCount);
+            freeSubtree(location.node);
+        }
+
+        // Rows after this one moved
+        rows.invalidate();
+        invalidate();
+    }
+
+    void TreeView::collapseAll()
+    {
+        nodes.resize(1);
+        nodes[0].expandedChildren.clear();
+        freeNodes.clear();
+        nodes[0].rowCount = pDataSource ? pDataSource->getChildCount(TREE_ROOT) : 0;
+        rows.invalidate();
+        invalidate();
+    }
+
+    uint32_t TreeView::recount(uint32_t node)
+    {
+        // Drop expanded children that are gone or moved, and count what is left
+        auto &expandedNode = nodes[node];
+        auto childCount = pDataSource->getChildCount(expandedNode.item);
+        uint32_t rowCount = childCount;
+        auto &children = expandedNode.expandedChildren;
+        for (auto it = children.begin(); it != children.end();)
+        {
+            auto child = *it;
+            const auto &childNode = nodes[child];
+            if (childNode.childIndex >= childCount || pDataSource->getChild(expandedNode.item, childNode.childIndex) != childNode.item)
+            {
+                freeSubtree(child);
+                it = children.erase(it);
+                continue;
+            }
+            rowCount += recount(child);
+            ++it;
+        }
+
+        nodes[node].rowCount = rowCount;
+        return rowCount;
+    }
+
+    void TreeView::refresh()
+    {
+        if (!pDataSource)
+        {
+            collapseAll();
+            return;
+        }
+
+        recount(0);
+        rows.invalidate();
+        invalidate();
+    }
+
+    Vec2 TreeView::measure(Context *pContext, const Vec2 &available)
+    {
+        return { available.x, (float)((double)getRowCount() * (double)pContext->theme.listItemHeight) };
+    }
+
+    void TreeView::arrange(Context *pContext, const Rect &in_rect, const Rect &viewport)
+    {
+        rect = in_rect;
+        rows.update(getTop(), viewport, pContext->theme.listItemHeight, getRowCount(), [this](VirtualRow &row)
+        {
+            auto location = locate(row.index);
+            const auto &parentNode = nodes[location.parent];
+            row.item = location.node != NONE ? nodes[location.node].item : pDataSource->getChild(parentNode.item, location.childIndex);
+            row.depth = parentNode.depth;
+            row.isExpanded = location.node != NONE;
+            row.hasChildren = row.isExpanded || pDataSource->getChildCount(row.item) != 0;
+            row.text.clear();
+            pDataSource->getText(row.item, row.text);
+        });
+    }
+
+    void TreeView::render(Context *pContext)
+    {
+        rows.render(pContext, rect, true);
+    }
+
+    void TreeView::onMouseButtonDown(Context *pContext, int button, const Vec2 &position)
+    {
+        const auto &theme = pContext->theme;
+        if (button != 0 || !pDataSource || theme.listItemHeight <= 0.0f) return;
+
+        auto rowPos = ((double)position.y - (double)rect.y) / (double)theme.listItemHeight;
+        if (rowPos < 0.0 || rowPos >= (double)getRowCount()) return;
+        auto row = (uint32_t)rowPos;
+
+        // Toggle when clicking the expander, drawn in front of the text
+        auto expanderX = rect.x + theme.controlPadding + (float)nodes[locate(row).parent].depth * theme.treeIndent;
+        if (position.x < expanderX || position.x >= expanderX + theme.treeIndent) return;
+        setExpanded(row, !isExpanded(row));
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ogui/ITreeView.h"
+#include "VirtualRows.h"
+
+#include <vector>
+
+namespace ogui
+{
+    // Only expanded items are stored. Each one knows how many rows its subtree shows, and its expanded children
+    // sorted by index, so finding the item at a row never looks at the collapsed ones.
+    class TreeView final : public ITreeView
+    {
+    public:
+        TreeView(ITreeDataSource *pDataSource);
+
+        void setDataSource(ITreeDataSource *pDataSource) override;
+        void refresh() override;
+        uint32_t getRowCount() const override { return nodes[0].rowCount; }
+        uint64_t getItem(uint32_t row) const override;
+        void setExpanded(uint32_t row, bool expanded) override;
+        bool isExpanded(uint32_t row) const override;
+        void collapseAll() override;
+
+        Vec2 measure(Context *pContext, const Vec2 &available) override;
+        void arrange(Context *pContext, const Rect &rect, const Rect &viewport) override;
+        void render(Context *pContext) override;
+        void onMouseButtonDown(Context *pContext, int button, const Vec2 &position) override;
+
+    private:
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        struct ExpandedNode
+        {
+            uint64_t item = TREE_ROOT;
+            uint32_t parent = NONE;     // Index in nodes. NONE for the root, and for free nodes.
+            uint32_t childIndex = 0;    // Index of item in its parent's children
+            uint32_t depth = 0;         // Depth of the item's children
+            uint32_t rowCount = 0;      // Rows shown under the item: its children, and theirs when expanded
+            std::vector<uint32_t> expandedChildren; // Index in nodes, sorted by childIndex
+        };
+
+        struct Location
+        {
+            uint32_t parent;    // Expanded node holding the row's item
+            uint32_t childIndex;
+            uint32_t node;      // Expanded node of the row's item, NONE if collapsed
+        };
+
+        Location locate(uint32_t row) const;
+        uint32_t allocNode();
+        void freeSubtree(uint32_t node);
+        void addRows(uint32_t node, int64_t delta);
+        uint32_t recount(uint32_t node);
+
+        ITreeDataSource *pDataSource = nullptr;
+        std::vector<ExpandedNode> nodes; // nodes[0] is the root
+        std::vector<uint32_t> freeNodes;
+        std::vector<uint32_t> stack; // Traversal scratch
+        VirtualRows rows;
+    };
+}
@@ -0,0 +1,53 @@
+#include "VertexFormat.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ogui
+{
+    static CompactVertex ToCompactVertex(const Vertex &vertex)
+    {
+        CompactVertex ret;
+        ret.x = (int16_t)std::min(std::max(std::nearbyint(vertex.position.x), -32768.0f), 32767.0f);
+        ret.y = (int16_t)std::min(std::max(std::nearbyint(vertex.position.y), -32768.0f), 32767.0f);
+        ret.u = (uint16_t)std::nearbyint(std::min(std::max(vertex.uv.x, 0.0f), 1.0f) * 65535.0f);
+        ret.v = (uint16_t)std::nearbyint(std::min(std::max(vertex.uv.y, 0.0f), 1.0f) * 65535.0f);
+        ret.color = vertex.color;
+        return ret;
+    }
+
+    void ToCompactVertices(const Vertex *pVertices, CompactVertex *pOut, uint32_t count)
+    {
+        static_assert(sizeof(CompactVertex) == 12, "CompactVertex must be tightly packed.");
+
+        uint32_t i = 0;
+#if defined(OGUI_SSE2)
+        // Two vertices per iteration. UVs are biased into the signed range so the saturating signed pack can be used, then flipped back.
+        const auto scale = _mm_setr_ps(1.0f, 1.0f, 65535.0f, 65535.0f);
+        const auto uvMin = _mm_setr_ps(-32768.0f, -32768.0f, 0.0f, 0.0f);
+        const auto uvMax = _mm_setr_ps(32767.0f, 32767.0f, 1.0f, 1.0f);
+        const auto bias = _mm_setr_epi32(0, 0, 32768, 32768);
+        const auto unbias = _mm_setr_epi16(0, 0, (short)0x8000, (short)0x8000, 0, 0, (short)0x8000, (short)0x8000);
+        for (; i + 2 <= count; i += 2)
+        {
+            auto a = _mm_loadu_ps(&pVertices[i].position.x);
+            auto b = _mm_loadu_ps(&pVertices[i + 1].position.x);
+            a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(a, uvMin), uvMax), scale);
+            b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(b, uvMin), uvMax), scale);
+            auto ia = _mm_sub_epi32(_mm_cvtps_epi32(a), bias);
+            auto ib = _mm_sub_epi32(_mm_cvtps_epi32(b), bias);
+            auto packed = _mm_xor_si128(_mm_packs_epi32(ia, ib), unbias);
+
+            _mm_storel_epi64((__m128i *)&pOut[i].x, packed);
+            _mm_storel_epi64((__m128i *)&pOut[i + 1].x, _mm_unpackhi_epi64(packed, packed));
+            pOut[i].color = pVertices[i].color;
+            pOut[i + 1].color = pVertices[i + 1].color;
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            pOut[i] = ToCompactVertex(pVertices[i]);
+        }
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "ogui/types.h"
+
+namespace ogui
+{
+    void ToCompactVertices(const Vertex *pVertices, CompactVertex *pOut, uint32_t count);
+}
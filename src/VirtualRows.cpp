@@ -0,0 +1,37 @@
+#include "VirtualRows.h"
+#include "Context.h"
+#include "Font.h"
+
+namespace ogui
+{
+    void VirtualRows::invalidate()
+    {
+        for (auto &row : pool) row.index = 0xFFFFFFFF;
+    }
+
+    void VirtualRows::render(Context *pContext, const Rect &rect, bool hasExpanders) const
+    {
+        static const std::string EXPANDED_TEXT = "-";
+        static const std::string COLLAPSED_TEXT = "+";
+
+        const auto &theme = pContext->theme;
+        auto pFont = pContext->getFont(theme.font, theme.fontSize);
+        for (auto i = first; i < last; ++i)
+        {
+            const auto &row = pool[i % pool.size()];
+
+            // In view, so small enough for a float once placed
+            Rect rowRect = { rect.x, (float)(top + (double)i * itemHeight), rect.w, itemHeight };
+            if (!pContext->isDamaged(rowRect)) continue;
+
+            auto x = rowRect.x + theme.controlPadding + (float)row.depth * theme.treeIndent;
+            auto y = rowRect.y + (itemHeight - pFont->size) * 0.5f;
+            if (hasExpanders)
+            {
+                if (row.hasChildren) pContext->drawText(*pFont, row.isExpanded ? EXPANDED_TEXT : COLLAPSED_TEXT, { x, y }, theme.textColor);
+                x += theme.treeIndent;
+            }
+            pContext->drawText(*pFont, row.text, { x, y }, theme.textColor);
+        }
+    }
+}
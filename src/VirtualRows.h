@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ogui/types.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace ogui
+{
+    class Context;
+
+    struct VirtualRow
+    {
+        uint32_t index = 0xFFFFFFFF; // Row it currently shows
+        uint64_t item = 0;
+        uint32_t depth = 0;
+        bool hasChildren = false;
+        bool isExpanded = false;
+        std::string text;
+    };
+
+    // Visible rows of a list or tree. The pool only holds as many rows as fit in the viewport, row i uses slot
+    // i % pool size. When scrolling, rows still in view keep their content and only the slots of the rows that
+    // came into view are filled again.
+    class VirtualRows final
+    {
+    public:
+        template<typename FillFn>
+        void update(double top, const Rect &viewport, float itemHeight, uint32_t count, FillFn fill); // top is Widget::getTop()
+        void invalidate(); // Every visible row is filled again on the next update
+        void render(Context *pContext, const Rect &rect, bool hasExpanders) const;
+
+        uint32_t first = 0; // Visible rows
+        uint32_t last = 0;  // Exclusive
+
+    private:
+        std::vector<VirtualRow> pool;
+        float itemHeight = 0.0f;
+        double top = 0.0; // Of row 0. Rows are placed from it in double, they can be millions of pixels down.
+    };
+
+    template<typename FillFn>
+    void VirtualRows::update(double in_top, const Rect &viewport, float in_itemHeight, uint32_t count, FillFn fill)
+    {
+        itemHeight = in_itemHeight;
+        top = in_top;
+        first = 0;
+        last = 0;
+
+        // rect's y and height are floats, far down they are off by a few pixels
+        auto visibleTop = std::max(top, (double)viewport.y);
+        auto visibleBottom = std::min(top + (double)count * itemHeight, (double)viewport.y + viewport.h);
+        if (visibleBottom <= visibleTop || itemHeight <= 0.0f) return;
+
+        first = std::min(count, (uint32_t)((visibleTop - top) / itemHeight));
+        last = std::min(count, (uint32_t)std::ceil((visibleBottom - top) / itemHeight));
+
+        // Slots move around when the pool grows, fill them all again
+        auto visibleCount = (size_t)(last - first);
+        if (visibleCount > pool.size())
+        {
+            pool.resize(visibleCount);
+            invalidate();
+        }
+
+        for (auto i = first; i < last; ++i)
+        {
+            auto &row = pool[i % pool.size()];
+            if (row.index == i) continue;
+            row.index = i;
+            fill(row);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "ogui/Widget.h"
+#include "Context.h"
+#include "Panel.h"
+
+#include <algorithm>
+
+namespace ogui
+{
+    static bool RectEquals(const Rect &a, const Rect &b)
+    {
+        return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+    }
+
+    void Widget::invalidate()
+    {
+        ++version;
+        isArranged = false;
+        if (pPanel) pPanel->invalidateLayout();
+    }
+
+    void Widget::arrange(Context * /*pContext*/, const Rect &in_rect, const Rect & /*viewport*/)
+    {
+        rect = in_rect;
+    }
+
+    const Vec2 &Widget::measureCached(Context *pContext, const Vec2 &available)
+    {
+        // Available height is always infinite, only the width matters
+        if (measuredVersion != version || measuredThemeVersion != pContext->themeVersion || measuredWidth != available.x)
+        {
+            measuredSize = measure(pContext, available);
+            measuredVersion = version;
+            measuredThemeVersion = pContext->themeVersion;
+            measuredWidth = available.x;
+        }
+        return measuredSize;
+    }
+
+    void Widget::arrangeCached(Context *pContext, const Rect &in_rect, double in_top, const Rect &viewport)
+    {
+        // Widgets that only care about their visible part, like lists, are arranged again when it changes
+        Rect visibleRect = { 0.0f, 0.0f, 0.0f, 0.0f };
+        auto x1 = std::max(in_rect.x, viewport.x);
+        auto y1 = std::max(in_rect.y, viewport.y);
+        auto x2 = std::min(in_rect.x + in_rect.w, viewport.x + viewport.w);
+        auto y2 = std::min(in_rect.y + in_rect.h, viewport.y + viewport.h);
+        if (x2 > x1 && y2 > y1) visibleRect = { x1, y1, x2 - x1, y2 - y1 };
+
+        // Far down, scrolling can move the top without changing the float rect
+        if (isArranged && in_top == arrangedTop && RectEquals(in_rect, arrangedRect) && RectEquals(visibleRect, arrangedVisibleRect)) return;
+
+        top = in_top;
+        arrange(pContext, in_rect, viewport);
+        isArranged = true;
+        arrangedRect = in_rect;
+        arrangedTop = in_top;
+        arrangedVisibleRect = visibleRect;
+    }
+}
@@ -0,0 +1,100 @@
+#include "WidgetList.h"
+
+namespace ogui
+{
+    uint32_t WidgetList::findSlot(const Widget *pWidget) const
+    {
+        auto it = slotIndex.find(pWidget);
+        return it == slotIndex.end() ? NONE : it->second;
+    }
+
+    void WidgetList::link(const WidgetRef &pWidget, uint32_t prev, uint32_t next)
+    {
+        uint32_t slot;
+        if (freeSlot != NONE)
+        {
+            slot = freeSlot;
+            freeSlot = slots[slot].next;
+        }
+        else
+        {
+            slot = (uint32_t)slots.size();
+            slots.emplace_back();
+        }
+
+        auto &newSlot = slots[slot];
+        newSlot.pWidget = pWidget;
+        newSlot.prev = prev;
+        newSlot.next = next;
+        if (prev == NONE) head = slot;
+        else slots[prev].next = slot;
+        if (next == NONE) tail = slot;
+        else slots[next].prev = slot;
+
+        slotIndex[pWidget.get()] = slot;
+        ++count;
+    }
+
+    bool WidgetList::pushBack(const WidgetRef &pWidget)
+    {
+        if (!pWidget) return false;
+        if (tail != NONE && slots[tail].pWidget == pWidget) return false;
+
+        remove(pWidget.get());
+        link(pWidget, tail, NONE);
+        return true;
+    }
+
+    bool WidgetList::insertBefore(const WidgetRef &pWidget, const Widget *pBefore)
+    {
+        if (!pWidget || pWidget.get() == pBefore) return false;
+
+        remove(pWidget.get());
+        auto next = findSlot(pBefore);
+        link(pWidget, next == NONE ? tail : slots[next].prev, next);
+        return true;
+    }
+
+    bool WidgetList::insertAfter(const WidgetRef &pWidget, const Widget *pAfter)
+    {
+        if (!pWidget || pWidget.get() == pAfter) return false;
+
+        remove(pWidget.get());
+        auto prev = findSlot(pAfter);
+        if (prev == NONE) prev = tail;
+        link(pWidget, prev, prev == NONE ? NONE : slots[prev].next);
+        return true;
+    }
+
+    bool WidgetList::remove(const Widget *pWidget)
+    {
+        auto it = slotIndex.find(pWidget);
+        if (it == slotIndex.end()) return false;
+        auto slot = it->second;
+        slotIndex.erase(it);
+
+        auto &oldSlot = slots[slot];
+        if (oldSlot.prev == NONE) head = oldSlot.next;
+        else slots[oldSlot.prev].next = oldSlot.next;
+        if (oldSlot.next == NONE) tail = oldSlot.prev;
+        else slots[oldSlot.next].prev = oldSlot.prev;
+
+        oldSlot.pWidget.reset();
+        oldSlot.prev = NONE;
+        oldSlot.next = freeSlot;
+        freeSlot = slot;
+        --count;
+        return true;
+    }
+
+    void WidgetList::clear()
+    {
+        // Keeps the slots' capacity, rebuilding the panel won't allocate them again
+        slots.clear();
+        slotIndex.clear();
+        head = NONE;
+        tail = NONE;
+        freeSlot = NONE;
+        count = 0;
+    }
+}
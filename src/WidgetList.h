@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ogui/IPanel.h"
+
+#include <cinttypes>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace ogui
+{
+    // Widgets of a panel, in draw order. Slots are linked to their siblings by index and a map finds the slot of a
+    // widget, so inserting next to or removing a known widget is constant time and never moves the other widgets.
+    // Freed slots are reused. A widget is in the list at most once, adding it again moves it.
+    class WidgetList final
+    {
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        struct Slot
+        {
+            WidgetRef pWidget;
+            uint32_t prev = NONE;
+            uint32_t next = NONE; // Next free slot when the slot is free
+        };
+
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = WidgetRef;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const WidgetRef *;
+            using reference = const WidgetRef &;
+
+            Iterator(const Slot *in_pSlots, uint32_t in_slot) : pSlots(in_pSlots), slot(in_slot) {}
+
+            reference operator*() const { return pSlots[slot].pWidget; }
+            pointer operator->() const { return &pSlots[slot].pWidget; }
+            Iterator &operator++() { slot = pSlots[slot].next; return *this; }
+            Iterator operator++(int) { auto ret = *this; slot = pSlots[slot].next; return ret; }
+            bool operator==(const Iterator &other) const { return slot == other.slot; }
+            bool operator!=(const Iterator &other) const { return slot != other.slot; }
+
+        private:
+            const Slot *pSlots;
+            uint32_t slot;
+        };
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+        bool contains(const Widget *pWidget) const { return slotIndex.count(pWidget) != 0; }
+
+        Iterator begin() const { return Iterator(slots.data(), head); }
+        Iterator end() const { return Iterator(slots.data(), NONE); }
+
+        // Return false when nothing changed. Inserting next to a widget not in the list adds at the end.
+        bool pushBack(const WidgetRef &pWidget);
+        bool insertBefore(const WidgetRef &pWidget, const Widget *pBefore);
+        bool insertAfter(const WidgetRef &pWidget, const Widget *pAfter);
+        bool remove(const Widget *pWidget);
+        void clear();
+
+    private:
+        uint32_t findSlot(const Widget *pWidget) const;
+        void link(const WidgetRef &pWidget, uint32_t prev, uint32_t next);
+
+        std::vector<Slot> slots;
+        std::unordered_map<const Widget *, uint32_t> slotIndex;
+        uint32_t head = NONE;
+        uint32_t tail = NONE;
+        uint32_t freeSlot = NONE;
+        size_t count = 0;
+    };
+}